@@ -1,9 +1,19 @@
 #include <cmath>
+#include <algorithm>
 #include <random>
 #include <vector>
 #include <chrono>
 #include <iostream>
 #include <cstring>
+#include <complex>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <coroutine>
+#include <memory>
+#include <queue>
+#include <new>
 
 // ========================================================================
 // REAL INDUSTRIAL MOTOR PHYSICS ENGINE
@@ -93,6 +103,29 @@ static bool initialized = false;
 static std::chrono::steady_clock::time_point startTime;
 static bool physicsUpdatedThisReading = false;  // Flag to prevent multiple updates per reading
 
+// Shared ambient conditions of the fleet machine being stepped, from the
+// plant environment model. Null for the live motor, which keeps its
+// per-scenario ambient figures.
+struct AmbientConditions {
+    double temperature;     // °C
+    double humidity;        // % RH
+    double pressure;        // kPa
+    double hourOfDay;       // 0-24
+    double seasonalFactor;  // ~0.85-1.15, summer high
+};
+static const AmbientConditions* machineAmbient = nullptr;
+
+// Simulated seconds covered by the fleet machine being stepped. Zero for the
+// live motor, which ages by one increment per reading; fleet machines apply
+// the same increments as rates per operating hour.
+static double machineStepSeconds = 0.0;
+const double AGING_REFERENCE_SECONDS = 3600.0;  // s - Simulated time per aging increment
+
+// Scale of this update's wear/degradation increments
+double AgingScale() {
+    return machineStepSeconds > 0.0 ? machineStepSeconds / AGING_REFERENCE_SECONDS : 1.0;
+}
+
 // ========================================================================
 // REAL INDUSTRIAL PHYSICS FUNCTIONS
 // ========================================================================
@@ -170,6 +203,12 @@ double CalculateSpeed() {
         case 7: // Generator - High load, power demand dependent
             baseSpeed = 2700.0; operatingLoad = 0.80; ambientTemp = 50.0; timeOfDay = 18.0; seasonalFactor = 1.2; break;
     }
+    if (machineAmbient != nullptr) {
+        // Fleet machines share the plant environment instead of per-scenario figures
+        ambientTemp = machineAmbient->temperature;
+        timeOfDay = machineAmbient->hourOfDay;
+        seasonalFactor = machineAmbient->seasonalFactor;
+    }
     
     // STEP 2: Apply real industrial physics with significant variations
     // Real physics: Speed = f(load, ambient conditions, time, season, wear, maintenance)
@@ -228,6 +267,7 @@ double CalculateTemperature() {
         case 5: // High-speed motor - Thermal stress
             baseTemp = 55.0; ambientTemp = 35.0; coolingEfficiency = 0.65; thermalMass = 0.9; break;
     }
+    if (machineAmbient != nullptr) ambientTemp = machineAmbient->temperature;
     
     // STEP 3: Apply real industrial thermal physics
     // Real physics: Temperature = f(speed, load, ambient, cooling, thermal mass, wear)
@@ -491,7 +531,7 @@ double CalculateBearingWear() {
     double speedWear = (motor.speed / BASE_SPEED - 1.0) * 0.005;  // Speed affects wear
     
     // Calculate bearing wear with realistic variations
-    double newWear = motor.bearingWear + timeWear + loadWear + tempWear + speedWear;
+    double newWear = motor.bearingWear + (timeWear + loadWear + tempWear + speedWear) * AgingScale();
     
     // Clamp to realistic range
     newWear = std::max(0.0, std::min(1.0, newWear));
@@ -513,7 +553,8 @@ double CalculateOilDegradation() {
     double contaminationDegradation = motor.bearingWear * 0.01;  // Bearing wear affects oil
     
     // Calculate oil degradation with realistic variations
-    double newDegradation = motor.oilDegradation + timeDegradation + tempDegradation + contaminationDegradation;
+    double newDegradation = motor.oilDegradation +
+        (timeDegradation + tempDegradation + contaminationDegradation) * AgingScale();
     
     // Clamp to realistic range
     newDegradation = std::max(0.0, std::min(1.0, newDegradation));
@@ -527,6 +568,13 @@ double CalculateOilDegradation() {
 double CalculateOperatingHours() {
     InitializeMotor();
     
+    // Fleet machines accumulate the simulated run time of the step
+    if (machineStepSeconds > 0.0) {
+        motor.operatingHours += machineStepSeconds / 3600.0;
+        motor.boatEngineHours = (int)(motor.operatingHours * 0.8);
+        return motor.operatingHours;
+    }
+
     // Real physics: Operating hours increase with actual runtime
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - startTime);
@@ -567,8 +615,13 @@ void UpdateMotorPhysics() {
     motor.current = 20.0 + (motor.speed / BASE_SPEED) * 15.0;
     motor.powerFactor = 0.92;
     
-    motor.humidity = 45.0 + (motor.temperature / 100.0);
-    motor.ambientPressure = 101.325 + (motor.temperature / 100.0);
+    if (machineAmbient != nullptr) {
+        motor.humidity = machineAmbient->humidity;
+        motor.ambientPressure = machineAmbient->pressure;
+    } else {
+        motor.humidity = 45.0 + (motor.temperature / 100.0);
+        motor.ambientPressure = 101.325 + (motor.temperature / 100.0);
+    }
     motor.shaftPosition = (motor.speed * 0.1);  // Shaft position based on speed
     motor.displacement = motor.vibration / 10.0;
     
@@ -726,244 +779,4842 @@ void UpdateMotorPhysics() {
 }
 
 // ========================================================================
-// C API FUNCTIONS FOR C# BACKEND
+// INDUSTRIAL MACHINE FLEET
 // ========================================================================
+// Every industrial machine keeps its own MotorState and is advanced in
+// simulated time by StepFleet(). The single live motor behind the Get*
+// functions above is not touched by fleet stepping.
 
-// Basic motor parameters
-extern "C" double GetMotorSpeed() {
-    UpdateMotorPhysics();
-    return motor.speed;
-}
+static std::vector<MotorState> fleet;
+static double fleetSimTime = 0.0;  // s - Simulated time since fleet start
 
-extern "C" double GetMotorTemperature() {
-    UpdateMotorPhysics();
-    return motor.temperature;
-}
+// Plant clock: the calendar position of simulated time 0 (SetEnvironmentClock).
+// Everything that depends on the time of day (tariffs, forecast seasons, the
+// environment, shift scripts) reads it through these helpers.
+static int plantStartDay = 1;        // Day of year 1-365
+static double plantStartHour = 0.0;  // Hour of day 0-24
 
-extern "C" double GetMotorEfficiency() {
-    UpdateMotorPhysics();
-    return motor.efficiency;
+// Days since Jan 1 00:00 of the plant's first year at simulated time simSeconds
+double PlantDays(double simSeconds) {
+    return simSeconds / 86400.0 + (plantStartDay - 1) + plantStartHour / 24.0;
 }
 
-extern "C" double GetMotorPowerConsumption() {
-    UpdateMotorPhysics();
-    return motor.powerConsumption;
+// Hour of day 0-24 on the plant clock
+double PlantHourOfDay(double simSeconds) {
+    double hour = std::fmod(PlantDays(simSeconds), 1.0) * 24.0;
+    return hour < 0.0 ? hour + 24.0 : hour;
 }
 
-extern "C" double GetMotorVibration() {
-    UpdateMotorPhysics();
-    return motor.vibration;
-}
+// Advance one machine by reusing the single-motor physics: the machine is
+// swapped into the live slot, updated, and swapped back out. Aging and
+// operating hours advance by the simulated step, not per call.
+void StepMachinePhysics(int index, double dtSeconds) {
+    MotorState liveMotor = motor;
+    bool liveUpdated = physicsUpdatedThisReading;
 
-extern "C" double GetMotorLoad() {
-    UpdateMotorPhysics();
-    return motor.load;
-}
+    motor = fleet[index];
+    if (motor.isRunning) {
+        physicsUpdatedThisReading = false;
+        machineStepSeconds = dtSeconds;
+        UpdateMotorPhysics();
+        machineStepSeconds = 0.0;
+    } else {
+        // Stopped machine: no rotation, no load, no electrical draw
+        motor.speed = 0.0; motor.rpm = 0.0; motor.load = 0.0;
+        motor.powerConsumption = 0.0; motor.current = 0.0; motor.torque = 0.0;
+    }
+    fleet[index] = motor;
 
-extern "C" double GetMotorBearingWear() {
-    UpdateMotorPhysics();
-    return motor.bearingWear;
+    motor = liveMotor;
+    physicsUpdatedThisReading = liveUpdated;
 }
 
-extern "C" double GetMotorOilDegradation() {
-    UpdateMotorPhysics();
-    return motor.oilDegradation;
-}
+// ========================================================================
+// OEE ACCUMULATORS (Availability x Performance x Quality)
+// ========================================================================
+// OEE is integrated per machine as the fleet steps, so shift/day/week
+// figures are constant-time reads instead of queries over reading lists.
+//   Availability = run time / planned time
+//   Performance  = actual output / ideal output (speed vs rated speed)
+//   Quality      = good output / actual output (losses from maintenanceStatus)
 
-extern "C" double GetMotorOperatingHours() {
-    UpdateMotorPhysics();
-    return motor.operatingHours;
-}
+const double OEE_RATED_SPEED = BASE_SPEED;         // RPM - Ideal throughput reference
+const double OEE_HOUR_SECONDS = 3600.0;
+const int OEE_HOUR_BUCKETS = 24;                   // Hourly buckets (shift/day windows)
+const int OEE_DAY_BUCKETS = 7;                     // Daily buckets (week window)
+const int OEE_SHIFT_HOURS = 8;
 
-// 3-axis vibration sensors
-extern "C" double GetVibrationX() {
-    UpdateMotorPhysics();
-    return motor.vibrationX;
-}
+// Fraction of output lost to scrap/rework per maintenance status
+// Status codes: 0=Good, 1=Warning, 2=Critical, 3=Maintenance Due
+const double OEE_QUALITY_LOSS[4] = { 0.0, 0.10, 1.0, 0.02 };
 
-extern "C" double GetVibrationY() {
-    UpdateMotorPhysics();
-    return motor.vibrationY;
-}
+// OEE windows exposed through the C API
+const int OEE_WINDOW_SHIFT = 0;
+const int OEE_WINDOW_DAY = 1;
+const int OEE_WINDOW_WEEK = 2;
+const int OEE_WINDOW_LIFETIME = 3;
+const int OEE_WINDOW_COUNT = 4;
 
-extern "C" double GetVibrationZ() {
-    UpdateMotorPhysics();
-    return motor.vibrationZ;
-}
+struct OEECounters {
+    double plannedTime;   // s - Time the machine was scheduled
+    double runTime;       // s - Time the machine was running
+    double idealOutput;   // rev - Rated speed x run time
+    double actualOutput;  // rev - Actual speed x run time
+    double goodOutput;    // rev - Actual output minus quality losses
+};
 
-// Pressure sensors
-extern "C" double GetOilPressure() {
-    UpdateMotorPhysics();
-    return motor.oilPressure;
-}
+struct MachineOEE {
+    OEECounters hour[OEE_HOUR_BUCKETS];  // Ring of closed and current hourly buckets
+    OEECounters day[OEE_DAY_BUCKETS];    // Ring of closed and current daily buckets
+    OEECounters window[OEE_WINDOW_COUNT];  // Running sums per window
+};
 
-extern "C" double GetAirPressure() {
-    UpdateMotorPhysics();
-    return motor.airPressure;
+static std::vector<MachineOEE> machineOEE;
+static OEECounters fleetOEE[OEE_WINDOW_COUNT];
+static long long oeeCurrentHour = 0;  // Index of the open hourly bucket
+
+void AddOEECounters(OEECounters& target, const OEECounters& delta, double sign) {
+    target.plannedTime += sign * delta.plannedTime;
+    target.runTime += sign * delta.runTime;
+    target.idealOutput += sign * delta.idealOutput;
+    target.actualOutput += sign * delta.actualOutput;
+    target.goodOutput += sign * delta.goodOutput;
 }
 
-extern "C" double GetHydraulicPressure() {
-    UpdateMotorPhysics();
-    return motor.hydraulicPressure;
+void ResizeOEEAccumulators(int count) {
+    machineOEE.assign(count, MachineOEE());
+    std::memset(fleetOEE, 0, sizeof(fleetOEE));
+    oeeCurrentHour = 0;
 }
 
-// Flow rate sensors
-extern "C" double GetCoolantFlowRate() {
-    UpdateMotorPhysics();
-    return motor.coolantFlowRate;
+// Close the current hour: the buckets that fall out of each rolling window
+// are subtracted from the running sums, so no window is ever re-summed.
+void RotateOEEHour() {
+    long long nextHour = oeeCurrentHour + 1;
+    int hourSlot = (int)(nextHour % OEE_HOUR_BUCKETS);
+    int shiftExpired = (int)((nextHour - OEE_SHIFT_HOURS) % OEE_HOUR_BUCKETS);
+    bool dayRollover = (nextHour % OEE_HOUR_BUCKETS) == 0;
+    int daySlot = (int)((nextHour / OEE_HOUR_BUCKETS) % OEE_DAY_BUCKETS);
+
+    for (MachineOEE& m : machineOEE) {
+        if (nextHour >= OEE_SHIFT_HOURS) {
+            AddOEECounters(m.window[OEE_WINDOW_SHIFT], m.hour[shiftExpired], -1.0);
+            AddOEECounters(fleetOEE[OEE_WINDOW_SHIFT], m.hour[shiftExpired], -1.0);
+        }
+        if (nextHour >= OEE_HOUR_BUCKETS) {
+            AddOEECounters(m.window[OEE_WINDOW_DAY], m.hour[hourSlot], -1.0);
+            AddOEECounters(fleetOEE[OEE_WINDOW_DAY], m.hour[hourSlot], -1.0);
+        }
+        std::memset(&m.hour[hourSlot], 0, sizeof(OEECounters));
+
+        if (dayRollover) {
+            if (nextHour >= (long long)OEE_HOUR_BUCKETS * OEE_DAY_BUCKETS) {
+                AddOEECounters(m.window[OEE_WINDOW_WEEK], m.day[daySlot], -1.0);
+                AddOEECounters(fleetOEE[OEE_WINDOW_WEEK], m.day[daySlot], -1.0);
+            }
+            std::memset(&m.day[daySlot], 0, sizeof(OEECounters));
+        }
+    }
+    oeeCurrentHour = nextHour;
 }
 
-extern "C" double GetFuelFlowRate() {
-    UpdateMotorPhysics();
-    return motor.fuelFlowRate;
+// Integrate one fleet step into every machine's OEE counters
+void UpdateOEEAccumulators(double dtSeconds) {
+    int hourSlot = (int)(oeeCurrentHour % OEE_HOUR_BUCKETS);
+    int daySlot = (int)((oeeCurrentHour / OEE_HOUR_BUCKETS) % OEE_DAY_BUCKETS);
+
+    for (size_t i = 0; i < fleet.size(); i++) {
+        const MotorState& state = fleet[i];
+        OEECounters delta;
+        delta.plannedTime = dtSeconds;
+        delta.runTime = state.isRunning ? dtSeconds : 0.0;
+        delta.idealOutput = delta.runTime * OEE_RATED_SPEED / 60.0;
+        delta.actualOutput = delta.runTime * std::min(state.speed, OEE_RATED_SPEED) / 60.0;
+        int status = std::max(0, std::min(3, state.maintenanceStatus));
+        delta.goodOutput = delta.actualOutput * (1.0 - OEE_QUALITY_LOSS[status]);
+
+        MachineOEE& m = machineOEE[i];
+        AddOEECounters(m.hour[hourSlot], delta, 1.0);
+        AddOEECounters(m.day[daySlot], delta, 1.0);
+        for (int w = 0; w < OEE_WINDOW_COUNT; w++) {
+            AddOEECounters(m.window[w], delta, 1.0);
+            AddOEECounters(fleetOEE[w], delta, 1.0);
+        }
+    }
+
+    // Roll hourly buckets for every hour boundary crossed by this step
+    while (fleetSimTime >= (oeeCurrentHour + 1) * OEE_HOUR_SECONDS) {
+        RotateOEEHour();
+    }
 }
 
-// Electrical monitoring
-extern "C" double GetVoltage() {
-    UpdateMotorPhysics();
-    return motor.voltage;
+double OEEAvailability(const OEECounters& c) {
+    return c.plannedTime > 0.0 ? c.runTime / c.plannedTime * 100.0 : 0.0;
 }
 
-extern "C" double GetCurrent() {
-    UpdateMotorPhysics();
-    return motor.current;
+double OEEPerformance(const OEECounters& c) {
+    return c.idealOutput > 0.0 ? c.actualOutput / c.idealOutput * 100.0 : 0.0;
 }
 
-extern "C" double GetPowerFactor() {
-    UpdateMotorPhysics();
-    return motor.powerFactor;
+double OEEQuality(const OEECounters& c) {
+    return c.actualOutput > 0.0 ? c.goodOutput / c.actualOutput * 100.0 : 0.0;
 }
 
-extern "C" double GetPowerConsumption() {
-    UpdateMotorPhysics();
-    return motor.powerConsumption;
+double OEEScore(const OEECounters& c) {
+    return OEEAvailability(c) * OEEPerformance(c) * OEEQuality(c) / 10000.0;
 }
 
-// Mechanical measurements
-extern "C" double GetRPM() {
-    UpdateMotorPhysics();
-    return motor.rpm;
+// Resolve a machine/window pair; index -1 selects the whole fleet
+const OEECounters* FindOEECounters(int index, int window) {
+    if (window < 0 || window >= OEE_WINDOW_COUNT) return nullptr;
+    if (index == -1) return &fleetOEE[window];
+    if (index < 0 || index >= (int)machineOEE.size()) return nullptr;
+    return &machineOEE[index].window[window];
 }
 
-extern "C" double GetTorque() {
-    UpdateMotorPhysics();
-    return motor.torque;
+// ========================================================================
+// ENERGY AND COST INTEGRATION (time-of-use tariffs, demand charges)
+// ========================================================================
+// Energy is integrated per machine with the trapezoidal rule at the fleet
+// step rate and priced with the tariff band active over each part of the step.
+// Plant totals are maintained alongside, so energy/cost KPIs are O(1) reads.
+
+const double DEFAULT_ENERGY_PRICE = 0.12;    // $/kWh - Flat rate used by the backend
+const int TARIFF_SLOTS_PER_HOUR = 4;         // 15-minute tariff resolution
+const int TARIFF_SLOTS = 24 * TARIFF_SLOTS_PER_HOUR;
+const double DEFAULT_DEMAND_INTERVAL = 900.0;  // s - 15-minute utility demand interval
+
+// Tariff bands are compiled into a per-slot price table for O(1) lookup
+static double tariffPrice[TARIFF_SLOTS];
+static bool tariffInitialized = false;
+static double demandChargePerKW = 0.0;       // $/kW - Charged on billing-period peak demand
+static double demandIntervalSeconds = DEFAULT_DEMAND_INTERVAL;
+
+struct MachineEnergy {
+    double lastPower;          // kW - Power at the end of the previous step
+    double energyKWh;          // kWh - Energy in the billing period
+    double energyCost;         // $ - Time-of-use energy cost in the billing period
+    double intervalEnergyKWh;  // kWh - Energy in the open demand interval
+    double peakDemandKW;       // kW - Highest closed demand interval
+};
+
+struct PlantEnergy {
+    double powerKW;            // kW - Instantaneous plant load
+    double energyKWh;
+    double energyCost;
+    double intervalEnergyKWh;
+    double lastDemandKW;       // kW - Most recently closed demand interval
+    double peakDemandKW;
+    double intervalStart;      // s - Simulated time the open interval began
+};
+
+static std::vector<MachineEnergy> machineEnergy;
+static PlantEnergy plantEnergy;
+
+void InitializeTariff() {
+    if (tariffInitialized) return;
+    for (int i = 0; i < TARIFF_SLOTS; i++) {
+        tariffPrice[i] = DEFAULT_ENERGY_PRICE;
+    }
+    tariffInitialized = true;
 }
 
-extern "C" double GetEfficiency() {
-    UpdateMotorPhysics();
-    return motor.efficiency;
+double TariffPriceAt(double simSeconds) {
+    InitializeTariff();
+    int slot = (int)(PlantHourOfDay(simSeconds) * TARIFF_SLOTS_PER_HOUR);
+    return tariffPrice[std::max(0, std::min(TARIFF_SLOTS - 1, slot))];
 }
 
-// Environmental sensors
-extern "C" double GetHumidity() {
-    UpdateMotorPhysics();
-    return motor.humidity;
+void ResizeEnergyAccumulators(int count) {
+    machineEnergy.assign(count, MachineEnergy());
+    for (int i = 0; i < count; i++) {
+        machineEnergy[i].lastPower = fleet[i].isRunning ? fleet[i].powerConsumption : 0.0;
+    }
+    plantEnergy = PlantEnergy();
 }
 
-extern "C" double GetAmbientTemperature() {
-    UpdateMotorPhysics();
-    return motor.ambientTemperature;
+// Close the open demand interval: demand is its average power
+void CloseDemandInterval() {
+    double hours = demandIntervalSeconds / 3600.0;
+    for (MachineEnergy& e : machineEnergy) {
+        e.peakDemandKW = std::max(e.peakDemandKW, e.intervalEnergyKWh / hours);
+        e.intervalEnergyKWh = 0.0;
+    }
+    plantEnergy.lastDemandKW = plantEnergy.intervalEnergyKWh / hours;
+    plantEnergy.peakDemandKW = std::max(plantEnergy.peakDemandKW, plantEnergy.lastDemandKW);
+    plantEnergy.intervalEnergyKWh = 0.0;
+    plantEnergy.intervalStart += demandIntervalSeconds;
 }
 
-extern "C" double GetAmbientPressure() {
-    UpdateMotorPhysics();
-    return motor.ambientPressure;
+// Price weights for a step that crosses tariff slot boundaries. Power ramps
+// linearly over the step (u = 0..1), so its cost is
+// hours * (lastPower * flat + (power - lastPower) * ramp), with flat and ramp
+// summing each slot's price over the part of the step it covers.
+void TariffStepWeights(double startSeconds, double dtSeconds, double& flat, double& ramp) {
+    const double slotSeconds = 3600.0 / TARIFF_SLOTS_PER_HOUR;
+    InitializeTariff();
+    flat = 0.0;
+    ramp = 0.0;
+    if (dtSeconds > 24.0 * 3600.0) {
+        // Steps longer than a day see every slot; price them at the daily mean
+        for (int i = 0; i < TARIFF_SLOTS; i++) flat += tariffPrice[i];
+        flat /= TARIFF_SLOTS;
+        ramp = 0.5 * flat;
+        return;
+    }
+    double u0 = 0.0;
+    while (u0 < 1.0) {
+        // Slot boundaries fall on the plant clock, not on multiples of simulated time
+        double t = startSeconds + u0 * dtSeconds;
+        double boundary = t + slotSeconds - std::fmod(PlantHourOfDay(t) * 3600.0, slotSeconds);
+        double u1 = std::min(1.0, (boundary - startSeconds) / dtSeconds);
+        if (u1 <= u0) u1 = std::min(1.0, u0 + slotSeconds / dtSeconds);  // Rounding at a boundary
+        double price = TariffPriceAt(startSeconds + 0.5 * (u0 + u1) * dtSeconds);
+        flat += price * (u1 - u0);
+        ramp += price * 0.5 * (u1 * u1 - u0 * u0);
+        u0 = u1;
+    }
 }
 
-// Position sensors
-extern "C" double GetShaftPosition() {
-    UpdateMotorPhysics();
-    return motor.shaftPosition;
+// Integrate one fleet step (called after fleetSimTime has advanced); steps
+// that span several tariff slots are priced slot by slot
+void UpdateEnergyAccumulators(double dtSeconds) {
+    double flat, ramp;
+    TariffStepWeights(fleetSimTime - dtSeconds, dtSeconds, flat, ramp);
+    double hours = dtSeconds / 3600.0;
+    double plantLastPower = 0.0;
+    double plantPower = 0.0;
+    double plantStepEnergy = 0.0;
+
+    for (size_t i = 0; i < fleet.size(); i++) {
+        MachineEnergy& e = machineEnergy[i];
+        double power = fleet[i].powerConsumption;
+
+        // Trapezoidal rule between the previous and current step
+        double stepEnergy = 0.5 * (e.lastPower + power) * hours;
+        e.energyKWh += stepEnergy;
+        e.energyCost += (e.lastPower * flat + (power - e.lastPower) * ramp) * hours;
+        e.intervalEnergyKWh += stepEnergy;
+        plantLastPower += e.lastPower;
+        e.lastPower = power;
+
+        plantPower += power;
+        plantStepEnergy += stepEnergy;
+    }
+
+    plantEnergy.powerKW = plantPower;
+    plantEnergy.energyKWh += plantStepEnergy;
+    plantEnergy.energyCost += (plantLastPower * flat + (plantPower - plantLastPower) * ramp) * hours;
+    plantEnergy.intervalEnergyKWh += plantStepEnergy;
+
+    while (fleetSimTime >= plantEnergy.intervalStart + demandIntervalSeconds) {
+        CloseDemandInterval();
+    }
 }
 
-extern "C" double GetDisplacement() {
-    UpdateMotorPhysics();
-    return motor.displacement;
+void ResetEnergyBilling() {
+    for (MachineEnergy& e : machineEnergy) {
+        e.energyKWh = 0.0; e.energyCost = 0.0;
+        e.intervalEnergyKWh = 0.0; e.peakDemandKW = 0.0;
+    }
+    double powerKW = plantEnergy.powerKW;
+    plantEnergy = PlantEnergy();
+    plantEnergy.powerKW = powerKW;
+    plantEnergy.intervalStart = fleetSimTime;
 }
 
-// Strain sensors
-extern "C" double GetStrainGauge1() {
-    UpdateMotorPhysics();
-    return motor.strainGauge1;
+// ========================================================================
+// MACHINE STATE INTERVAL LOG (MTBF / MTTR / uptime)
+// ========================================================================
+// Every machine keeps an append-only log of state intervals. Start/stop
+// calls and maintenanceStatus changes close the open interval and open a
+// new one. Per-machine prefix sums answer uptime over any time range with
+// a binary search, and a per-state interval index answers "which machines
+// were in state S between t0 and t1" in O(log n + k).
+// Intervals that closed more than the retention window ago are dropped
+// (amortized, once at least half of a log is expired); range queries that
+// reach further back are clamped to the oldest retained interval. MTBF,
+// MTTR and failure counts are running totals and are not affected.
+
+const int MACHINE_STATE_RUN = 0;          // Running, status Good
+const int MACHINE_STATE_IDLE = 1;         // Stopped
+const int MACHINE_STATE_WARNING = 2;      // Running, status Warning
+const int MACHINE_STATE_CRITICAL = 3;     // Running, status Critical (failure)
+const int MACHINE_STATE_MAINTENANCE = 4;  // Running, status Maintenance Due
+const int MACHINE_STATE_COUNT = 5;
+const double DEFAULT_STATE_LOG_RETENTION = 7.0 * 24.0 * 3600.0;  // s - One week of range queries
+const int STATE_LOG_TRIM_MIN = 64;        // Intervals before a per-machine log is considered for trimming
+const int STATE_INDEX_COMPACT_MIN = 1024; // Entries before a per-state index is considered for compaction
+
+struct StateInterval {
+    double start;   // s - Simulated time the interval opened
+    double end;     // s - Simulated time it closed (open interval: INFINITY)
+    int state;
+    int indexSlot;  // Position in the per-state interval index
+};
+
+struct MachineStateLog {
+    std::vector<StateInterval> intervals;
+    std::vector<double> cumulative;  // Time per state before each interval start (MACHINE_STATE_COUNT per interval)
+    double stateTotals[MACHINE_STATE_COUNT];  // s - Closed time per state
+    double uptime;                   // s - Closed time in up states
+    int failures;                    // Transitions into Critical
+    int repairs;                     // Returns to Run after a failure
+    double repairTime;               // s - Failure onset to return to Run
+    double failureStart;
+    bool awaitingRepair;
+};
+
+// Intervals of one state across the whole fleet, stored in start order
+// (intervals open at the current simulated time, which never decreases).
+// A max-end segment tree over that order prunes the overlap search.
+struct IntervalIndex {
+    std::vector<double> start;
+    std::vector<double> end;
+    std::vector<int> machine;
+    std::vector<double> maxEnd;  // Segment tree; leaves at [capacity, 2 * capacity)
+    int capacity;
+    int compactAt;               // Entry count that triggers the next compaction
+};
+
+static std::vector<MachineStateLog> machineStateLog;
+static IntervalIndex stateIndex[MACHINE_STATE_COUNT];
+static std::vector<int> stateQueryStamp;  // Per-machine dedup marker for fleet queries
+static int stateQueryCounter = 0;
+static double stateLogRetentionSeconds = DEFAULT_STATE_LOG_RETENTION;
+
+// Fleet-wide reliability counters
+static double fleetUptime = 0.0;         // s - Closed up time across machines
+static double fleetOpenUpStartSum = 0.0; // Sum of start times of open up intervals
+static int fleetOpenUpCount = 0;
+static int fleetFailures = 0;
+static int fleetRepairs = 0;
+static double fleetRepairTime = 0.0;
+
+bool IsUpState(int state) {
+    return state == MACHINE_STATE_RUN || state == MACHINE_STATE_WARNING || state == MACHINE_STATE_MAINTENANCE;
 }
 
-extern "C" double GetStrainGauge2() {
-    UpdateMotorPhysics();
-    return motor.strainGauge2;
+int ClassifyMachineState(const MotorState& state) {
+    if (!state.isRunning) return MACHINE_STATE_IDLE;
+    switch (state.maintenanceStatus) {
+        case 1: return MACHINE_STATE_WARNING;
+        case 2: return MACHINE_STATE_CRITICAL;
+        case 3: return MACHINE_STATE_MAINTENANCE;
+        default: return MACHINE_STATE_RUN;
+    }
 }
 
-extern "C" double GetStrainGauge3() {
-    UpdateMotorPhysics();
-    return motor.strainGauge3;
+void UpdateIntervalIndexEnd(IntervalIndex& index, int slot, double end) {
+    index.end[slot] = end;
+    int node = slot + index.capacity;
+    index.maxEnd[node] = end;
+    for (node /= 2; node >= 1; node /= 2) {
+        index.maxEnd[node] = std::max(index.maxEnd[2 * node], index.maxEnd[2 * node + 1]);
+    }
 }
 
-// Acoustic sensors
-extern "C" double GetSoundLevel() {
-    UpdateMotorPhysics();
-    return motor.soundLevel;
+int AppendIntervalIndex(IntervalIndex& index, double start, int machineIndex) {
+    int slot = (int)index.start.size();
+    if (slot >= index.capacity) {
+        // Grow by doubling and rebuild the tree bottom-up (amortized O(1))
+        index.capacity = std::max(64, index.capacity * 2);
+        index.maxEnd.assign(2 * index.capacity, -INFINITY);
+        for (int i = 0; i < slot; i++) {
+            index.maxEnd[index.capacity + i] = index.end[i];
+        }
+        for (int node = index.capacity - 1; node >= 1; node--) {
+            index.maxEnd[node] = std::max(index.maxEnd[2 * node], index.maxEnd[2 * node + 1]);
+        }
+    }
+    index.start.push_back(start);
+    index.end.push_back(INFINITY);
+    index.machine.push_back(machineIndex);
+    UpdateIntervalIndexEnd(index, slot, INFINITY);
+    return slot;
 }
 
-extern "C" double GetBearingHealth() {
-    UpdateMotorPhysics();
-    return motor.bearingHealth;
+// Visit every interval in slots [0, limit) whose end lies after t0
+void CollectIntervalOverlaps(const IntervalIndex& index, int node, int nodeLo, int nodeHi,
+                             int limit, double t0, int* machines, int maxMachines, int& count) {
+    if (nodeLo >= limit || index.maxEnd[node] <= t0 || count >= maxMachines) return;
+    if (nodeHi - nodeLo == 1) {
+        int m = index.machine[nodeLo];
+        if (stateQueryStamp[m] != stateQueryCounter) {
+            stateQueryStamp[m] = stateQueryCounter;
+            machines[count++] = m;
+        }
+        return;
+    }
+    int mid = (nodeLo + nodeHi) / 2;
+    CollectIntervalOverlaps(index, 2 * node, nodeLo, mid, limit, t0, machines, maxMachines, count);
+    CollectIntervalOverlaps(index, 2 * node + 1, mid, nodeHi, limit, t0, machines, maxMachines, count);
 }
 
-// System status
-extern "C" int GetOperatingHours() {
-    UpdateMotorPhysics();
-    return (int)motor.operatingHours;
+// Drop the intervals that closed before the horizon once they are at least
+// half of the log; the prefix sums of the rest are absolute and stay valid
+void TrimStateLog(MachineStateLog& log, double horizon) {
+    size_t count = log.intervals.size();
+    if (count < (size_t)STATE_LOG_TRIM_MIN || log.intervals[count / 2].end >= horizon) return;
+    size_t expired = (size_t)(std::partition_point(log.intervals.begin(), log.intervals.end(),
+        [horizon](const StateInterval& interval) { return interval.end < horizon; }) - log.intervals.begin());
+    log.intervals.erase(log.intervals.begin(), log.intervals.begin() + expired);
+    log.cumulative.erase(log.cumulative.begin(), log.cumulative.begin() + expired * MACHINE_STATE_COUNT);
 }
 
-extern "C" int GetMaintenanceStatus() {
-    UpdateMotorPhysics();
-    return motor.maintenanceStatus;
+// Remove entries that closed before the horizon (and zero-length ones),
+// keeping start order, and repoint the open intervals at their new slots
+void CompactIntervalIndex(IntervalIndex& index, double horizon) {
+    int count = (int)index.start.size();
+    if (count < std::max(STATE_INDEX_COMPACT_MIN, index.compactAt)) return;
+
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        if (index.end[i] < horizon || index.end[i] == -INFINITY) continue;
+        index.start[kept] = index.start[i];
+        index.end[kept] = index.end[i];
+        index.machine[kept] = index.machine[i];
+        if (index.end[i] == INFINITY) {
+            machineStateLog[index.machine[i]].intervals.back().indexSlot = kept;
+        }
+        kept++;
+    }
+    index.start.resize(kept);
+    index.end.resize(kept);
+    index.machine.resize(kept);
+
+    index.capacity = 64;
+    while (index.capacity < kept) index.capacity *= 2;
+    index.maxEnd.assign(2 * index.capacity, -INFINITY);
+    for (int i = 0; i < kept; i++) {
+        index.maxEnd[index.capacity + i] = index.end[i];
+    }
+    for (int node = index.capacity - 1; node >= 1; node--) {
+        index.maxEnd[node] = std::max(index.maxEnd[2 * node], index.maxEnd[2 * node + 1]);
+    }
+    index.compactAt = 2 * kept;
 }
 
-extern "C" double GetSystemHealth() {
-    UpdateMotorPhysics();
-    return motor.systemHealth;
+void OpenStateInterval(int index, int state, double now) {
+    MachineStateLog& log = machineStateLog[index];
+    StateInterval interval;
+    interval.start = now;
+    interval.end = INFINITY;
+    interval.state = state;
+    interval.indexSlot = AppendIntervalIndex(stateIndex[state], now, index);
+    log.intervals.push_back(interval);
+    log.cumulative.insert(log.cumulative.end(), log.stateTotals, log.stateTotals + MACHINE_STATE_COUNT);
+
+    if (IsUpState(state)) {
+        fleetOpenUpCount++;
+        fleetOpenUpStartSum += now;
+    }
 }
 
-// Daily Life Applications
-extern "C" double GetHVACEfficiency() {
-    UpdateMotorPhysics();
-    return motor.hvacEfficiency;
+void TransitionMachineState(int index, int newState, double now) {
+    MachineStateLog& log = machineStateLog[index];
+    StateInterval& open = log.intervals.back();
+    if (open.state == newState) return;
+
+    // Close the open interval
+    double duration = now - open.start;
+    open.end = now;
+    log.stateTotals[open.state] += duration;
+    // Zero-length intervals (e.g. stopped in the same instant) drop out of the index
+    UpdateIntervalIndexEnd(stateIndex[open.state], open.indexSlot, duration > 0.0 ? now : -INFINITY);
+    if (IsUpState(open.state)) {
+        log.uptime += duration;
+        fleetUptime += duration;
+        fleetOpenUpCount--;
+        fleetOpenUpStartSum -= open.start;
+    }
+
+    // Failure onset and repair completion; Critical -> Warning -> Critical
+    // before the machine is back in Run is still the same failure
+    if (newState == MACHINE_STATE_CRITICAL) {
+        if (!log.awaitingRepair) {
+            log.failures++;
+            fleetFailures++;
+            log.awaitingRepair = true;
+            log.failureStart = now;
+        }
+    } else if (newState == MACHINE_STATE_RUN && log.awaitingRepair) {
+        log.awaitingRepair = false;
+        log.repairs++;
+        log.repairTime += now - log.failureStart;
+        fleetRepairs++;
+        fleetRepairTime += now - log.failureStart;
+    }
+
+    OpenStateInterval(index, newState, now);
+    TrimStateLog(log, now - stateLogRetentionSeconds);
 }
 
-extern "C" double GetEnergySavings() {
-    UpdateMotorPhysics();
-    return motor.energySavings;
+void ResizeStateLogs(int count) {
+    machineStateLog.assign(count, MachineStateLog());
+    stateQueryStamp.assign(count, 0);
+    stateQueryCounter = 0;
+    for (int s = 0; s < MACHINE_STATE_COUNT; s++) {
+        stateIndex[s] = IntervalIndex();
+    }
+    fleetUptime = 0.0; fleetOpenUpStartSum = 0.0; fleetOpenUpCount = 0;
+    fleetFailures = 0; fleetRepairs = 0; fleetRepairTime = 0.0;
+
+    for (int i = 0; i < count; i++) {
+        OpenStateInterval(i, ClassifyMachineState(fleet[i]), fleetSimTime);
+    }
 }
 
-extern "C" double GetComfortLevel() {
-    UpdateMotorPhysics();
-    return motor.comfortLevel;
+void UpdateStateLogs() {
+    for (int i = 0; i < (int)fleet.size(); i++) {
+        TransitionMachineState(i, ClassifyMachineState(fleet[i]), fleetSimTime);
+    }
+    for (int s = 0; s < MACHINE_STATE_COUNT; s++) {
+        CompactIntervalIndex(stateIndex[s], fleetSimTime - stateLogRetentionSeconds);
+    }
 }
 
-extern "C" double GetAirQuality() {
-    UpdateMotorPhysics();
-    return motor.airQuality;
+// Cumulative time a machine spent in a state up to simulated time t
+// (clamped to the oldest retained interval)
+double MachineStateTimeUntil(const MachineStateLog& log, int state, double t) {
+    const std::vector<StateInterval>& intervals = log.intervals;
+    auto it = std::upper_bound(intervals.begin(), intervals.end(), t,
+        [](double value, const StateInterval& interval) { return value < interval.start; });
+    if (it == intervals.begin()) return log.cumulative[state];
+    size_t k = (size_t)(it - intervals.begin()) - 1;
+    double total = log.cumulative[k * MACHINE_STATE_COUNT + state];
+    if (intervals[k].state == state) {
+        total += std::min(t, std::min(intervals[k].end, fleetSimTime)) - intervals[k].start;
+    }
+    return total;
 }
 
-extern "C" int GetSmartDevices() {
-    UpdateMotorPhysics();
-    return motor.smartDevices;
+// Up time including the open interval
+double MachineUptime(const MachineStateLog& log) {
+    const StateInterval& open = log.intervals.back();
+    return log.uptime + (IsUpState(open.state) ? fleetSimTime - open.start : 0.0);
 }
 
-extern "C" double GetFuelEfficiency() {
-    UpdateMotorPhysics();
-    return motor.fuelEfficiency;
+// ========================================================================
+// FLEET STATUS BITSETS
+// ========================================================================
+// One bit per machine for each dashboard status. Every fleet step rewrites
+// the bits of all machines, and start/stop calls between steps update their
+// machine at once. Counts are popcounts over the words and filtered
+// iteration walks set bits with a bit scan, so fleet summaries never touch
+// the MotorStates.
+
+const int STATUS_RUNNING = 0;          // isRunning
+const int STATUS_STOPPED = 1;          // !isRunning
+const int STATUS_WARNING = 2;          // maintenanceStatus 1
+const int STATUS_CRITICAL = 3;         // maintenanceStatus 2
+const int STATUS_MAINTENANCE_DUE = 4;  // maintenanceStatus 3
+const int STATUS_SET_COUNT = 5;
+
+static std::vector<uint64_t> statusBits[STATUS_SET_COUNT];
+static std::vector<uint64_t> statusScratch;  // Combined filter words (reused, no per-query allocation)
+
+void SetStatusBit(int set, int index, bool value) {
+    uint64_t mask = 1ULL << (index & 63);
+    uint64_t& word = statusBits[set][index >> 6];
+    word = value ? (word | mask) : (word & ~mask);
 }
 
-extern "C" double GetEngineHealth() {
-    UpdateMotorPhysics();
-    return motor.engineHealth;
+void UpdateMachineStatusBits(int index) {
+    const MotorState& state = fleet[index];
+    SetStatusBit(STATUS_RUNNING, index, state.isRunning);
+    SetStatusBit(STATUS_STOPPED, index, !state.isRunning);
+    SetStatusBit(STATUS_WARNING, index, state.maintenanceStatus == 1);
+    SetStatusBit(STATUS_CRITICAL, index, state.maintenanceStatus == 2);
+    SetStatusBit(STATUS_MAINTENANCE_DUE, index, state.maintenanceStatus == 3);
 }
 
-extern "C" double GetBatteryLevel() {
-    UpdateMotorPhysics();
-    return motor.batteryLevel;
+void ResizeStatusBits(int count) {
+    size_t words = ((size_t)count + 63) / 64;
+    for (int s = 0; s < STATUS_SET_COUNT; s++) {
+        statusBits[s].assign(words, 0);
+    }
+    statusScratch.assign(words, 0);
+    for (int i = 0; i < count; i++) {
+        UpdateMachineStatusBits(i);
+    }
+}
+
+void UpdateStatusBits() {
+    for (int i = 0; i < (int)fleet.size(); i++) {
+        UpdateMachineStatusBits(i);
+    }
+}
+
+// The shipped build targets baseline x86-64, where __builtin_popcountll is a
+// libgcc call; on x86-64 Linux a POPCNT clone is picked at load time instead
+#if defined(__x86_64__) && defined(__linux__) && (defined(__GNUC__) || defined(__clang__))
+#define POPCNT_CLONES __attribute__((target_clones("popcnt", "default")))
+#else
+#define POPCNT_CLONES
+#endif
+
+// Population count over a word array
+POPCNT_CLONES uint64_t PopcountWords(const uint64_t* words, size_t count) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += (uint64_t)__builtin_popcountll(words[i]);
+    }
+    return total;
+}
+
+// AND together every status set selected by the flag mask (bit n = status n)
+const uint64_t* CombineStatusBits(int flags) {
+    size_t words = statusScratch.size();
+    bool first = true;
+    for (int s = 0; s < STATUS_SET_COUNT; s++) {
+        if (!(flags & (1 << s))) continue;
+        const uint64_t* set = statusBits[s].data();
+        if (first) {
+            // A single set needs no combining
+            if ((flags >> (s + 1)) == 0) return set;
+            std::memcpy(statusScratch.data(), set, words * sizeof(uint64_t));
+            first = false;
+        } else {
+            uint64_t* out = statusScratch.data();
+            for (size_t w = 0; w < words; w++) {
+                out[w] &= set[w];
+            }
+        }
+    }
+    return first ? nullptr : statusScratch.data();
+}
+
+// ========================================================================
+// AT-RISK MACHINE RANKING (indexed heaps)
+// ========================================================================
+// One indexed max-heap per risk metric keeps the fleet ordered by badness.
+// Each step only moves machines whose key changed (increase/decrease-key
+// via sift up/down), and a top-K query walks the heap best-first, so the
+// cost depends on K and never on a sort of the whole fleet.
+
+const int RISK_HEALTH = 0;        // Lowest systemHealth first
+const int RISK_TEMPERATURE = 1;   // Highest temperature first
+const int RISK_VIBRATION = 2;     // Highest vibration first
+const int RISK_RUL = 3;           // Shortest remaining useful life first
+const int RISK_METRIC_COUNT = 4;
+
+const double RUL_WEAR_LIMIT = 1.0;        // Bearing wear at end of life
+const double RUL_MAX_HOURS = 100000.0;    // Cap for machines with no measurable wear
+const double RUL_RATE_SMOOTHING = 0.1;    // EWMA weight for the wear rate
+
+struct IndexedHeap {
+    std::vector<int> heap;      // Machine indices in heap order
+    std::vector<int> position;  // Heap position of each machine
+    std::vector<double> key;    // Badness per machine (larger = worse)
+};
+
+static IndexedHeap riskHeap[RISK_METRIC_COUNT];
+static std::vector<double> machineWearRate;   // wear/s - Smoothed bearing wear rate
+static std::vector<double> machineLastWear;
+static std::vector<double> machineRUL;        // h - Remaining useful life estimate
+static std::vector<int> riskFrontier;         // Scratch for top-K traversal
+
+void SwapHeapNodes(IndexedHeap& h, int a, int b) {
+    std::swap(h.heap[a], h.heap[b]);
+    h.position[h.heap[a]] = a;
+    h.position[h.heap[b]] = b;
+}
+
+void SiftHeapUp(IndexedHeap& h, int node) {
+    while (node > 0) {
+        int parent = (node - 1) / 2;
+        if (h.key[h.heap[parent]] >= h.key[h.heap[node]]) break;
+        SwapHeapNodes(h, node, parent);
+        node = parent;
+    }
+}
+
+void SiftHeapDown(IndexedHeap& h, int node) {
+    int size = (int)h.heap.size();
+    while (true) {
+        int largest = node;
+        int left = 2 * node + 1, right = left + 1;
+        if (left < size && h.key[h.heap[left]] > h.key[h.heap[largest]]) largest = left;
+        if (right < size && h.key[h.heap[right]] > h.key[h.heap[largest]]) largest = right;
+        if (largest == node) break;
+        SwapHeapNodes(h, node, largest);
+        node = largest;
+    }
+}
+
+// Increase- or decrease-key in O(log n); unchanged keys cost nothing
+void UpdateHeapKey(IndexedHeap& h, int machineIndex, double key) {
+    double old = h.key[machineIndex];
+    if (key == old) return;
+    h.key[machineIndex] = key;
+    if (key > old) {
+        SiftHeapUp(h, h.position[machineIndex]);
+    } else {
+        SiftHeapDown(h, h.position[machineIndex]);
+    }
+}
+
+void ComputeRiskKeys(int index, double keys[RISK_METRIC_COUNT]) {
+    const MotorState& state = fleet[index];
+    keys[RISK_HEALTH] = -(double)state.systemHealth;
+    keys[RISK_TEMPERATURE] = state.temperature;
+    keys[RISK_VIBRATION] = state.vibration;
+    keys[RISK_RUL] = -machineRUL[index];
+}
+
+void ResizeRiskHeaps(int count) {
+    machineWearRate.assign(count, 0.0);
+    machineRUL.assign(count, RUL_MAX_HOURS);
+    machineLastWear.resize(count);
+    for (int i = 0; i < count; i++) {
+        machineLastWear[i] = fleet[i].bearingWear;
+    }
+
+    for (int m = 0; m < RISK_METRIC_COUNT; m++) {
+        IndexedHeap& h = riskHeap[m];
+        h.heap.resize(count);
+        h.position.resize(count);
+        h.key.resize(count);
+        for (int i = 0; i < count; i++) {
+            h.heap[i] = i;
+            h.position[i] = i;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        double keys[RISK_METRIC_COUNT];
+        ComputeRiskKeys(i, keys);
+        for (int m = 0; m < RISK_METRIC_COUNT; m++) riskHeap[m].key[i] = keys[m];
+    }
+    for (int m = 0; m < RISK_METRIC_COUNT; m++) {
+        for (int node = count / 2 - 1; node >= 0; node--) {
+            SiftHeapDown(riskHeap[m], node);
+        }
+    }
+}
+
+// Real physics: RUL = remaining wear margin / smoothed wear rate
+void UpdateMachineRUL(int index, double dtSeconds) {
+    double wear = fleet[index].bearingWear;
+    double rate = std::max(0.0, wear - machineLastWear[index]) / dtSeconds;
+    machineWearRate[index] += RUL_RATE_SMOOTHING * (rate - machineWearRate[index]);
+    machineLastWear[index] = wear;
+
+    double margin = std::max(0.0, RUL_WEAR_LIMIT - wear);
+    double hours = machineWearRate[index] > 0.0 ? margin / machineWearRate[index] / 3600.0 : RUL_MAX_HOURS;
+    machineRUL[index] = std::min(RUL_MAX_HOURS, hours);
+}
+
+void UpdateRiskHeaps(double dtSeconds) {
+    for (int i = 0; i < (int)fleet.size(); i++) {
+        UpdateMachineRUL(i, dtSeconds);
+        double keys[RISK_METRIC_COUNT];
+        ComputeRiskKeys(i, keys);
+        for (int m = 0; m < RISK_METRIC_COUNT; m++) {
+            UpdateHeapKey(riskHeap[m], i, keys[m]);
+        }
+    }
+}
+
+// Best-first walk of the heap: O(K log K) regardless of fleet size
+int CollectTopRisk(int metric, int k, int* machines) {
+    const IndexedHeap& h = riskHeap[metric];
+    int size = (int)h.heap.size();
+    auto worse = [&h](int a, int b) { return h.key[h.heap[a]] < h.key[h.heap[b]]; };
+
+    riskFrontier.clear();
+    if (size > 0) riskFrontier.push_back(0);
+    int count = 0;
+    while (count < k && !riskFrontier.empty()) {
+        std::pop_heap(riskFrontier.begin(), riskFrontier.end(), worse);
+        int node = riskFrontier.back();
+        riskFrontier.pop_back();
+        machines[count++] = h.heap[node];
+        for (int child = 2 * node + 1; child <= 2 * node + 2 && child < size; child++) {
+            riskFrontier.push_back(child);
+            std::push_heap(riskFrontier.begin(), riskFrontier.end(), worse);
+        }
+    }
+    return count;
+}
+
+// ========================================================================
+// MULTIVARIATE ANOMALY SCORING (streaming covariance, Mahalanobis distance)
+// ========================================================================
+// Each machine keeps a running mean and the Cholesky factor of its feature
+// covariance. Every step scores the new feature vector against the model
+// (Mahalanobis distance via forward substitution) and then folds it in with
+// a rank-one Cholesky update, so the covariance is never refactorized.
+// Machines are stored in blocks of ANOMALY_LANES with every matrix element
+// laid out lane-contiguous, so the kernels vectorize across machines.
+
+const int ANOMALY_MAX_FEATURES = 7;
+const int ANOMALY_LANES = 8;  // Machines per block (one SIMD-friendly lane group)
+const int ANOMALY_TRI = ANOMALY_MAX_FEATURES * (ANOMALY_MAX_FEATURES + 1) / 2;
+const double ANOMALY_PRIOR_WEIGHT = 10.0;  // Pseudo-samples carried by the prior covariance
+const double DEFAULT_ANOMALY_FORGETTING = 0.001;  // Minimum update weight (exponential forgetting)
+
+// Feature bits: 1=Temperature, 2=VibrationX, 4=VibrationY, 8=VibrationZ,
+// 16=Current, 32=Efficiency, 64=Power
+const int ANOMALY_ALL_FEATURES = 0x7f;
+
+// Prior standard deviation per feature (same order as the feature bits)
+const double ANOMALY_PRIOR_STD[ANOMALY_MAX_FEATURES] = { 8.0, 0.6, 0.6, 0.6, 3.0, 6.0, 1.5 };
+
+struct AnomalyBlock {
+    double mean[ANOMALY_MAX_FEATURES][ANOMALY_LANES];
+    double chol[ANOMALY_TRI][ANOMALY_LANES];  // Packed lower-triangular Cholesky factor
+    double count[ANOMALY_LANES];              // Samples seen (including prior weight)
+    double distance[ANOMALY_LANES];           // Mahalanobis distance of the latest sample
+};
+
+static std::vector<AnomalyBlock> anomalyBlocks;
+static int anomalyFeatureMask = ANOMALY_ALL_FEATURES;
+static int anomalyFeatures[ANOMALY_MAX_FEATURES];  // Active feature ids
+static int anomalyFeatureCount = ANOMALY_MAX_FEATURES;
+static double anomalyForgetting = DEFAULT_ANOMALY_FORGETTING;
+
+inline int TriIndex(int row, int col) {
+    return row * (row + 1) / 2 + col;
+}
+
+double AnomalyFeatureValue(const MotorState& state, int feature) {
+    switch (feature) {
+        case 0: return state.temperature;
+        case 1: return state.vibrationX;
+        case 2: return state.vibrationY;
+        case 3: return state.vibrationZ;
+        case 4: return state.current;
+        case 5: return state.efficiency;
+        default: return state.powerConsumption;
+    }
+}
+
+void ResizeAnomalyModels(int count) {
+    anomalyFeatureCount = 0;
+    for (int f = 0; f < ANOMALY_MAX_FEATURES; f++) {
+        if (anomalyFeatureMask & (1 << f)) anomalyFeatures[anomalyFeatureCount++] = f;
+    }
+
+    int blocks = (count + ANOMALY_LANES - 1) / ANOMALY_LANES;
+    anomalyBlocks.assign(blocks, AnomalyBlock());
+    for (int b = 0; b < blocks; b++) {
+        AnomalyBlock& block = anomalyBlocks[b];
+        std::memset(&block, 0, sizeof(AnomalyBlock));
+        for (int lane = 0; lane < ANOMALY_LANES; lane++) {
+            int index = b * ANOMALY_LANES + lane;
+            const MotorState& state = index < count ? fleet[index] : motor;
+            for (int i = 0; i < anomalyFeatureCount; i++) {
+                block.mean[i][lane] = AnomalyFeatureValue(state, anomalyFeatures[i]);
+                block.chol[TriIndex(i, i)][lane] = ANOMALY_PRIOR_STD[anomalyFeatures[i]];
+            }
+            block.count[lane] = ANOMALY_PRIOR_WEIGHT;
+        }
+    }
+}
+
+// Score and update one block of machines; inactive lanes get weight 0
+void UpdateAnomalyBlock(AnomalyBlock& block, const double x[][ANOMALY_LANES], const double active[ANOMALY_LANES]) {
+    const int n = anomalyFeatureCount;
+    double d[ANOMALY_MAX_FEATURES][ANOMALY_LANES];
+    double y[ANOMALY_MAX_FEATURES][ANOMALY_LANES];
+    double dist2[ANOMALY_LANES] = {};
+
+    // Deviation from the mean and forward substitution L y = d
+    for (int i = 0; i < n; i++) {
+        for (int lane = 0; lane < ANOMALY_LANES; lane++) {
+            d[i][lane] = (x[i][lane] - block.mean[i][lane]) * active[lane];
+            double sum = d[i][lane];
+            for (int j = 0; j < i; j++) {
+                sum -= block.chol[TriIndex(i, j)][lane] * y[j][lane];
+            }
+            y[i][lane] = sum / block.chol[TriIndex(i, i)][lane];
+            dist2[lane] += y[i][lane] * y[i][lane];
+        }
+    }
+
+    // Update weight: running average until it reaches the forgetting floor
+    double alpha[ANOMALY_LANES], scale[ANOMALY_LANES];
+    for (int lane = 0; lane < ANOMALY_LANES; lane++) {
+        block.distance[lane] = std::sqrt(dist2[lane]) * active[lane];
+        block.count[lane] += active[lane];
+        alpha[lane] = std::max(1.0 / block.count[lane], anomalyForgetting) * active[lane];
+        scale[lane] = std::sqrt(1.0 - alpha[lane]);
+    }
+
+    // mean += alpha d;  C = (1 - alpha)(C + alpha d d^T)
+    double v[ANOMALY_MAX_FEATURES][ANOMALY_LANES];
+    for (int i = 0; i < n; i++) {
+        for (int lane = 0; lane < ANOMALY_LANES; lane++) {
+            block.mean[i][lane] += alpha[lane] * d[i][lane];
+            v[i][lane] = std::sqrt(alpha[lane]) * d[i][lane];
+        }
+    }
+
+    // Rank-one Cholesky update of L with v, then scale by sqrt(1 - alpha)
+    for (int k = 0; k < n; k++) {
+        double c[ANOMALY_LANES], s[ANOMALY_LANES];
+        for (int lane = 0; lane < ANOMALY_LANES; lane++) {
+            double lkk = block.chol[TriIndex(k, k)][lane];
+            double r = std::sqrt(lkk * lkk + v[k][lane] * v[k][lane]);
+            c[lane] = r / lkk;
+            s[lane] = v[k][lane] / lkk;
+            block.chol[TriIndex(k, k)][lane] = r * scale[lane];
+        }
+        for (int i = k + 1; i < n; i++) {
+            double* lik = block.chol[TriIndex(i, k)];
+            for (int lane = 0; lane < ANOMALY_LANES; lane++) {
+                double updated = (lik[lane] + s[lane] * v[i][lane]) / c[lane];
+                v[i][lane] = c[lane] * v[i][lane] - s[lane] * updated;
+                lik[lane] = updated * scale[lane];
+            }
+        }
+    }
+}
+
+void UpdateAnomalyModels() {
+    int count = (int)fleet.size();
+    double x[ANOMALY_MAX_FEATURES][ANOMALY_LANES];
+    double active[ANOMALY_LANES];
+
+    for (int b = 0; b < (int)anomalyBlocks.size(); b++) {
+        for (int lane = 0; lane < ANOMALY_LANES; lane++) {
+            int index = b * ANOMALY_LANES + lane;
+            bool running = index < count && fleet[index].isRunning;
+            active[lane] = running ? 1.0 : 0.0;
+            for (int i = 0; i < anomalyFeatureCount; i++) {
+                x[i][lane] = running ? AnomalyFeatureValue(fleet[index], anomalyFeatures[i]) : 0.0;
+            }
+        }
+        UpdateAnomalyBlock(anomalyBlocks[b], x, active);
+    }
+}
+
+// ========================================================================
+// KALMAN STATE ESTIMATOR (per-machine sensor fusion)
+// ========================================================================
+// A linear Kalman filter per machine fuses the jittery raw channels into
+// estimated states: x = [temperature, thermal rate, load torque, speed,
+// vibration]. Measurement noise is diagonal, so each channel is applied as
+// a scalar update and no matrix is ever inverted. State and covariance are
+// stored structure-of-arrays (one array per element across the fleet) and
+// processed in blocks with fixed-size loops the compiler fully unrolls.
+
+const int KF_STATES = 5;
+const int KF_COV = KF_STATES * (KF_STATES + 1) / 2;  // Packed symmetric covariance
+const int KF_BLOCK = 64;                              // Machines per kernel block
+
+const int KF_TEMPERATURE = 0;  // °C
+const int KF_THERMAL_RATE = 1; // °C/s
+const int KF_TORQUE = 2;       // Nm
+const int KF_SPEED = 3;        // RPM
+const int KF_VIBRATION = 4;    // mm/s
+
+// Process noise spectral density per state (variance per second)
+const double KF_PROCESS_NOISE[KF_STATES] = { 0.01, 0.0001, 1.0, 2500.0, 0.05 };
+
+// Measurement noise variance: temperature, current, torque, speed, vibration
+const double KF_MEASUREMENT_NOISE[KF_STATES] = { 25.0, 4.0, 4.0, 10000.0, 1.0 };
+
+// Current sensor observes torque: current = 0.75 * torque - 17.5 (from the derived electrical model).
+// Machines whose current comes from the dq model (EnableElectricalModel) do
+// not follow this line, so the channel is skipped for them and their torque
+// is observed through the model's electromagnetic torque alone.
+const double KF_CURRENT_PER_TORQUE = 0.75;
+const double KF_CURRENT_OFFSET = -17.5;
+
+// Initial state uncertainty (variance)
+const double KF_INITIAL_VARIANCE[KF_STATES] = { 100.0, 0.01, 100.0, 250000.0, 4.0 };
+
+static std::vector<double> kfState[KF_STATES];  // SoA: kfState[s][machine]
+static std::vector<double> kfCov[KF_COV];       // SoA: kfCov[packed(i,j)][machine]
+static std::vector<unsigned char> kfCurrentFromModel;  // [machine] - Set by the dq model when it drove the current reading
+
+inline int SymIndex(int i, int j) {
+    return i >= j ? i * (i + 1) / 2 + j : j * (j + 1) / 2 + i;
+}
+
+void ResizeKalmanFilters(int count) {
+    for (int s = 0; s < KF_STATES; s++) kfState[s].assign(count, 0.0);
+    for (int c = 0; c < KF_COV; c++) kfCov[c].assign(count, 0.0);
+    kfCurrentFromModel.assign(count, 0);
+    for (int i = 0; i < count; i++) {
+        const MotorState& state = fleet[i];
+        kfState[KF_TEMPERATURE][i] = state.temperature;
+        kfState[KF_TORQUE][i] = state.torque;
+        kfState[KF_SPEED][i] = state.speed;
+        kfState[KF_VIBRATION][i] = state.vibration;
+        for (int s = 0; s < KF_STATES; s++) {
+            kfCov[SymIndex(s, s)][i] = KF_INITIAL_VARIANCE[s];
+        }
+    }
+}
+
+// Scalar measurement z = a[m] * x[j] + noise(r), applied to a block of
+// machines; a[m] = 0 leaves machine m unobserved by this channel.
+// Every inner loop runs across machines over contiguous memory.
+inline void KalmanChannelUpdate(double* x[KF_STATES], double* P[KF_COV], int n,
+                                int j, const double* a, const double* z, double r) {
+    double pj[KF_STATES][KF_BLOCK];
+    double gain[KF_BLOCK], innovation[KF_BLOCK];
+
+    for (int i = 0; i < KF_STATES; i++) {
+        const double* column = P[SymIndex(i, j)];
+        for (int m = 0; m < n; m++) pj[i][m] = column[m];
+    }
+    for (int m = 0; m < n; m++) {
+        gain[m] = a[m] / (a[m] * a[m] * pj[j][m] + r);
+        innovation[m] = z[m] - a[m] * x[j][m];
+    }
+    for (int i = 0; i < KF_STATES; i++) {
+        double* xi = x[i];
+        for (int m = 0; m < n; m++) xi[m] += gain[m] * pj[i][m] * innovation[m];
+    }
+    for (int i = 0; i < KF_STATES; i++) {
+        for (int k = 0; k <= i; k++) {
+            double* pik = P[SymIndex(i, k)];
+            for (int m = 0; m < n; m++) pik[m] -= a[m] * gain[m] * pj[i][m] * pj[k][m];
+        }
+    }
+}
+
+// Same measurement coefficient for every machine in the block
+inline void KalmanScalarUpdate(double* x[KF_STATES], double* P[KF_COV], int n,
+                               int j, double a, const double* z, double r) {
+    double coefficient[KF_BLOCK];
+    for (int m = 0; m < n; m++) coefficient[m] = a;
+    KalmanChannelUpdate(x, P, n, j, coefficient, z, r);
+}
+
+void UpdateKalmanBlock(int begin, int n, double dt) {
+    double* x[KF_STATES];
+    double* P[KF_COV];
+    for (int s = 0; s < KF_STATES; s++) x[s] = kfState[s].data() + begin;
+    for (int c = 0; c < KF_COV; c++) P[c] = kfCov[c].data() + begin;
+
+    // Predict: temperature integrates the thermal rate, the rest are random walks
+    //   x0 += dt x1;  P = F P F^T + Q dt  with F = I + dt e0 e1^T
+    double* p00 = P[SymIndex(0, 0)];
+    double* p01 = P[SymIndex(0, 1)];
+    const double* p11 = P[SymIndex(1, 1)];
+    for (int m = 0; m < n; m++) {
+        x[KF_TEMPERATURE][m] += dt * x[KF_THERMAL_RATE][m];
+        p00[m] += 2.0 * dt * p01[m] + dt * dt * p11[m];
+        p01[m] += dt * p11[m];
+    }
+    for (int k = 2; k < KF_STATES; k++) {
+        double* p0k = P[SymIndex(0, k)];
+        const double* p1k = P[SymIndex(1, k)];
+        for (int m = 0; m < n; m++) p0k[m] += dt * p1k[m];
+    }
+    for (int s = 0; s < KF_STATES; s++) {
+        double* pss = P[SymIndex(s, s)];
+        double q = KF_PROCESS_NOISE[s] * dt;
+        for (int m = 0; m < n; m++) pss[m] += q;
+    }
+
+    // Update with each sensor channel
+    double z[KF_BLOCK] = {};
+    for (int m = 0; m < n; m++) z[m] = fleet[begin + m].temperature;
+    KalmanScalarUpdate(x, P, n, KF_TEMPERATURE, 1.0, z, KF_MEASUREMENT_NOISE[0]);
+    double currentGain[KF_BLOCK];
+    for (int m = 0; m < n; m++) {
+        z[m] = fleet[begin + m].current - KF_CURRENT_OFFSET;
+        currentGain[m] = kfCurrentFromModel[begin + m] ? 0.0 : KF_CURRENT_PER_TORQUE;
+    }
+    KalmanChannelUpdate(x, P, n, KF_TORQUE, currentGain, z, KF_MEASUREMENT_NOISE[1]);
+    for (int m = 0; m < n; m++) z[m] = fleet[begin + m].torque;
+    KalmanScalarUpdate(x, P, n, KF_TORQUE, 1.0, z, KF_MEASUREMENT_NOISE[2]);
+    for (int m = 0; m < n; m++) z[m] = fleet[begin + m].speed;
+    KalmanScalarUpdate(x, P, n, KF_SPEED, 1.0, z, KF_MEASUREMENT_NOISE[3]);
+    for (int m = 0; m < n; m++) z[m] = fleet[begin + m].vibration;
+    KalmanScalarUpdate(x, P, n, KF_VIBRATION, 1.0, z, KF_MEASUREMENT_NOISE[4]);
+}
+
+void UpdateKalmanFilters(double dtSeconds) {
+    int count = (int)fleet.size();
+    for (int begin = 0; begin < count; begin += KF_BLOCK) {
+        UpdateKalmanBlock(begin, std::min(KF_BLOCK, count - begin), dtSeconds);
+    }
+}
+
+double KalmanEstimate(int index, int stateId) {
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return kfState[stateId][index];
+}
+
+// ========================================================================
+// THERMAL PARAMETER IDENTIFICATION (recursive least squares)
+// ========================================================================
+// Real physics: first-order thermal model C dT/dt = P_loss - (T - T_amb) / R
+// Discretized over a step:  dT = theta1 * (P_loss dt) - theta2 * ((T - T_amb) dt)
+// with theta1 = 1/C and theta2 = 1/(R C). A 2-parameter RLS estimator with
+// exponential forgetting tracks theta per machine from observed temperature,
+// loss power and ambient. Storage is structure-of-arrays and the update is
+// allocation-free, so the whole plant is refitted every step.
+
+const double THERMAL_DEFAULT_CAPACITANCE = 20000.0;  // J/K - Typical industrial motor frame
+const double THERMAL_DEFAULT_TIME_CONSTANT = 1000.0; // s - R x C
+const double DEFAULT_THERMAL_FORGETTING = 0.999;     // RLS forgetting factor
+const double THERMAL_PRIOR_SPREAD = 100.0;           // Initial covariance = (spread x theta)^2 / 100
+
+struct ThermalRLS {
+    std::vector<double> theta1, theta2;    // 1/C, 1/(RC)
+    std::vector<double> p00, p01, p11;     // Packed 2x2 parameter covariance
+    std::vector<double> lastTemperature;   // °C - Regressors from the previous step
+    std::vector<double> lastLossPower;     // W
+    std::vector<double> lastAmbient;       // °C
+};
+
+static ThermalRLS thermalRLS;
+static double thermalForgetting = DEFAULT_THERMAL_FORGETTING;
+
+// Real physics: losses = input power x (1 - efficiency)
+double MachineLossPower(const MotorState& state) {
+    return state.powerConsumption * 1000.0 * (1.0 - state.efficiency / 100.0);
+}
+
+void ResizeThermalRLS(int count) {
+    double theta1 = 1.0 / THERMAL_DEFAULT_CAPACITANCE;
+    double theta2 = 1.0 / THERMAL_DEFAULT_TIME_CONSTANT;
+    thermalRLS.theta1.assign(count, theta1);
+    thermalRLS.theta2.assign(count, theta2);
+    thermalRLS.p00.assign(count, theta1 * theta1 * THERMAL_PRIOR_SPREAD);
+    thermalRLS.p01.assign(count, 0.0);
+    thermalRLS.p11.assign(count, theta2 * theta2 * THERMAL_PRIOR_SPREAD);
+    thermalRLS.lastTemperature.resize(count);
+    thermalRLS.lastLossPower.resize(count);
+    thermalRLS.lastAmbient.resize(count);
+    for (int i = 0; i < count; i++) {
+        thermalRLS.lastTemperature[i] = fleet[i].temperature;
+        thermalRLS.lastLossPower[i] = MachineLossPower(fleet[i]);
+        thermalRLS.lastAmbient[i] = fleet[i].ambientTemperature;
+    }
+}
+
+void UpdateThermalRLS(double dtSeconds) {
+    const double lambda = thermalForgetting;
+    ThermalRLS& r = thermalRLS;
+
+    for (int i = 0; i < (int)fleet.size(); i++) {
+        const MotorState& state = fleet[i];
+        double phi1 = r.lastLossPower[i] * dtSeconds;
+        double phi2 = -(r.lastTemperature[i] - r.lastAmbient[i]) * dtSeconds;
+        double observed = state.temperature - r.lastTemperature[i];
+
+        r.lastTemperature[i] = state.temperature;
+        r.lastLossPower[i] = MachineLossPower(state);
+        r.lastAmbient[i] = state.ambientTemperature;
+        if (!state.isRunning) continue;  // No excitation while stopped
+
+        // Gain K = P phi / (lambda + phi^T P phi)
+        double pp0 = r.p00[i] * phi1 + r.p01[i] * phi2;
+        double pp1 = r.p01[i] * phi1 + r.p11[i] * phi2;
+        double denom = lambda + phi1 * pp0 + phi2 * pp1;
+        double k0 = pp0 / denom;
+        double k1 = pp1 / denom;
+
+        double error = observed - (r.theta1[i] * phi1 + r.theta2[i] * phi2);
+        r.theta1[i] += k0 * error;
+        r.theta2[i] += k1 * error;
+
+        // P = (P - K phi^T P) / lambda
+        r.p00[i] = (r.p00[i] - k0 * pp0) / lambda;
+        r.p01[i] = (r.p01[i] - k0 * pp1) / lambda;
+        r.p11[i] = (r.p11[i] - k1 * pp1) / lambda;
+    }
+}
+
+// Identified parameters, falling back to the defaults while the fit is non-physical
+double MachineThermalCapacitance(int index) {
+    double theta1 = thermalRLS.theta1[index];
+    return theta1 > 0.0 ? 1.0 / theta1 : THERMAL_DEFAULT_CAPACITANCE;
+}
+
+double MachineThermalTimeConstant(int index) {
+    double theta2 = thermalRLS.theta2[index];
+    return theta2 > 0.0 ? 1.0 / theta2 : THERMAL_DEFAULT_TIME_CONSTANT;
+}
+
+// Real physics: T(t) = T_amb + P R + (T0 - T_amb - P R) e^(-t / RC)
+double ForecastThermalResponse(int index, double horizonSeconds) {
+    const MotorState& state = fleet[index];
+    double tau = MachineThermalTimeConstant(index);
+    double resistance = tau / MachineThermalCapacitance(index);
+    double steadyState = state.ambientTemperature + MachineLossPower(state) * resistance;
+    return steadyState + (state.temperature - steadyState) * std::exp(-horizonSeconds / tau);
+}
+
+// ========================================================================
+// CHANNEL FORECASTING (Holt-Winters exponential smoothing)
+// ========================================================================
+// Each machine keeps level, trend and an hour-of-day seasonal profile per
+// forecast channel, updated in O(1) per sample as the fleet steps. Trend is
+// kept per second so irregular step sizes forecast correctly. With gamma
+// set to 0 the seasonal profile stays flat (double exponential smoothing).
+
+const int FORECAST_CHANNEL_COUNT = 6;  // 0=Temperature, 1=Vibration, 2=Efficiency, 3=Power, 4=Speed, 5=Current
+const int FORECAST_SEASON_SLOTS = 24;  // Hourly slots of the daily season
+const double DEFAULT_FORECAST_ALPHA = 0.1;   // Level smoothing
+const double DEFAULT_FORECAST_BETA = 0.01;   // Trend smoothing
+const double DEFAULT_FORECAST_GAMMA = 0.05;  // Seasonal smoothing
+
+struct HoltWintersState {
+    double level;
+    double trend;  // Units per second
+    double season[FORECAST_SEASON_SLOTS];
+};
+
+static std::vector<HoltWintersState> forecastStates;  // [machine * FORECAST_CHANNEL_COUNT + channel]
+static double forecastAlpha = DEFAULT_FORECAST_ALPHA;
+static double forecastBeta = DEFAULT_FORECAST_BETA;
+static double forecastGamma = DEFAULT_FORECAST_GAMMA;
+
+double ForecastChannelValue(const MotorState& state, int channel) {
+    switch (channel) {
+        case 0: return state.temperature;
+        case 1: return state.vibration;
+        case 2: return state.efficiency;
+        case 3: return state.powerConsumption;
+        case 4: return state.speed;
+        default: return state.current;
+    }
+}
+
+// Hourly season slot on the plant clock
+int SeasonSlotAt(double simSeconds) {
+    return std::min(FORECAST_SEASON_SLOTS - 1, (int)(PlantHourOfDay(simSeconds) * FORECAST_SEASON_SLOTS / 24.0));
+}
+
+void ResizeForecasters(int count) {
+    forecastStates.assign((size_t)count * FORECAST_CHANNEL_COUNT, HoltWintersState());
+    for (int i = 0; i < count; i++) {
+        for (int c = 0; c < FORECAST_CHANNEL_COUNT; c++) {
+            forecastStates[(size_t)i * FORECAST_CHANNEL_COUNT + c].level = ForecastChannelValue(fleet[i], c);
+        }
+    }
+}
+
+void UpdateForecasters(double dtSeconds) {
+    int slot = SeasonSlotAt(fleetSimTime);
+    for (int i = 0; i < (int)fleet.size(); i++) {
+        if (!fleet[i].isRunning) continue;
+        HoltWintersState* states = &forecastStates[(size_t)i * FORECAST_CHANNEL_COUNT];
+        for (int c = 0; c < FORECAST_CHANNEL_COUNT; c++) {
+            HoltWintersState& hw = states[c];
+            double y = ForecastChannelValue(fleet[i], c);
+            double previousLevel = hw.level;
+            double seasonal = hw.season[slot];
+
+            hw.level = forecastAlpha * (y - seasonal) + (1.0 - forecastAlpha) * (previousLevel + hw.trend * dtSeconds);
+            hw.trend = forecastBeta * (hw.level - previousLevel) / dtSeconds + (1.0 - forecastBeta) * hw.trend;
+            hw.season[slot] = forecastGamma * (y - hw.level) + (1.0 - forecastGamma) * seasonal;
+        }
+    }
+}
+
+double ForecastChannel(int index, int channel, double horizonSeconds) {
+    const HoltWintersState& hw = forecastStates[(size_t)index * FORECAST_CHANNEL_COUNT + channel];
+    return hw.level + hw.trend * horizonSeconds + hw.season[SeasonSlotAt(fleetSimTime + horizonSeconds)];
+}
+
+// ========================================================================
+// SNAPSHOT FEATURES
+// ========================================================================
+// Fixed feature vector describing one machine at one step, shared by the
+// native ML models. Order:
+//   0=Temperature, 1=Vibration, 2=VibrationX, 3=VibrationY, 4=VibrationZ,
+//   5=Efficiency, 6=Power, 7=Load, 8=BearingWear, 9=OilDegradation,
+//   10=Current, 11=Speed
+
+const int SNAPSHOT_FEATURE_COUNT = 12;
+
+void FillSnapshotFeatures(const MotorState& state, float* out) {
+    out[0] = (float)state.temperature;
+    out[1] = (float)state.vibration;
+    out[2] = (float)state.vibrationX;
+    out[3] = (float)state.vibrationY;
+    out[4] = (float)state.vibrationZ;
+    out[5] = (float)state.efficiency;
+    out[6] = (float)state.powerConsumption;
+    out[7] = (float)state.load;
+    out[8] = (float)state.bearingWear;
+    out[9] = (float)state.oilDegradation;
+    out[10] = (float)state.current;
+    out[11] = (float)state.speed;
+}
+
+static std::vector<float> fleetSnapshot;  // Row-major [machine][feature], refreshed every step
+
+void ResizeSnapshotFeatures(int count) {
+    fleetSnapshot.assign((size_t)count * SNAPSHOT_FEATURE_COUNT, 0.0f);
+    for (int i = 0; i < count; i++) {
+        FillSnapshotFeatures(fleet[i], &fleetSnapshot[(size_t)i * SNAPSHOT_FEATURE_COUNT]);
+    }
+}
+
+void UpdateSnapshotFeatures() {
+    for (int i = 0; i < (int)fleet.size(); i++) {
+        FillSnapshotFeatures(fleet[i], &fleetSnapshot[(size_t)i * SNAPSHOT_FEATURE_COUNT]);
+    }
+}
+
+// ========================================================================
+// NATIVE ML INFERENCE (gradient-boosted trees, int8 MLP)
+// ========================================================================
+// Small anomaly/maintenance models are loaded from text files and scored
+// over batches of snapshot feature rows. Every loaded model scores the
+// whole fleet each step into a preallocated output array.
+//
+// Gradient-boosted trees:
+//   gbt <trees> <nodes> <baseScore> <logistic 0|1>
+//   roots <root node index per tree>
+//   <feature> <threshold> <left> <right> <value>    one line per node (leaf: feature -1)
+// Rows go left when feature < threshold. Nodes of all trees live in one
+// flat array in pre-order (children after their parent), which rules out
+// cycles; trees are evaluated one at a time over the whole batch so the
+// active tree stays in cache.
+//
+// Multilayer perceptron (one ReLU hidden layer, sigmoid output):
+//   mlp <inputs> <hidden>
+//   norm <mean std per input>
+//   w1 <hidden x inputs, row-major>   b1 <hidden>   w2 <hidden>   b2 <bias>
+// Hidden weights are quantized to int8 per row at load; inputs are
+// quantized per row at score time and multiplied with int32 accumulation.
+
+const int ML_MODEL_GBT = 0;
+const int ML_MODEL_MLP = 1;
+const int ML_INT8_ALIGN = 32;  // Quantized rows are padded so the dot loop has no tail
+
+struct TreeNode {
+    int feature;      // -1 for leaves
+    float threshold;
+    int left, right;
+    float value;      // Leaf output
+};
+
+struct MLModel {
+    int kind;
+    int inputs;
+    // Gradient-boosted trees
+    std::vector<TreeNode> nodes;
+    std::vector<int> roots;
+    double baseScore;
+    bool logistic;
+    // MLP
+    int hidden;
+    int paddedInputs;
+    std::vector<float> inputMean, inputInvStd;
+    std::vector<int8_t> w1q;          // [hidden][paddedInputs]
+    std::vector<float> w1Scale;       // Per hidden row
+    std::vector<float> b1, w2;
+    float b2;
+    std::vector<int8_t> inputQ;       // Scratch: quantized input row
+    std::vector<float> hiddenOut;     // Scratch: hidden activations
+    // Fleet scores, refreshed every step
+    std::vector<double> fleetScores;
+    std::vector<double> batchScratch; // Scratch: per-row accumulators for tree batches
+};
+
+static std::vector<MLModel> mlModels;
+
+double Sigmoid(double x) {
+    return 1.0 / (1.0 + std::exp(-x));
+}
+
+// Dot product of two int8 vectors (length multiple of ML_INT8_ALIGN)
+int32_t DotInt8(const int8_t* a, const int8_t* b, int length) {
+    int32_t total = 0;
+    for (int i = 0; i < length; i++) {
+        total += (int32_t)a[i] * (int32_t)b[i];
+    }
+    return total;
+}
+
+// Symmetric per-row int8 quantization; returns the dequantization scale
+float QuantizeRow(const float* values, int count, int8_t* out) {
+    float maxAbs = 0.0f;
+    for (int i = 0; i < count; i++) maxAbs = std::max(maxAbs, std::fabs(values[i]));
+    float scale = maxAbs > 0.0f ? maxAbs / 127.0f : 1.0f;
+    float inv = 1.0f / scale;
+    for (int i = 0; i < count; i++) {
+        out[i] = (int8_t)std::lround(std::max(-127.0f, std::min(127.0f, values[i] * inv)));
+    }
+    return scale;
+}
+
+bool ReadModelValues(std::istream& in, const char* tag, std::vector<float>& out, size_t count) {
+    std::string word;
+    if (!(in >> word) || word != tag) return false;
+    out.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        if (!(in >> out[i])) return false;
+    }
+    return true;
+}
+
+bool ParseTreeModel(std::istream& in, MLModel& model) {
+    int trees = 0, nodes = 0, logistic = 0;
+    std::string word;
+    if (!(in >> trees >> nodes >> model.baseScore >> logistic) || trees <= 0 || nodes <= 0) return false;
+    model.logistic = logistic != 0;
+    if (!(in >> word) || word != "roots") return false;
+    model.roots.resize(trees);
+    for (int& root : model.roots) {
+        if (!(in >> root) || root < 0 || root >= nodes) return false;
+    }
+    model.nodes.resize(nodes);
+    for (int i = 0; i < nodes; i++) {
+        TreeNode& node = model.nodes[i];
+        if (!(in >> node.feature >> node.threshold >> node.left >> node.right >> node.value)) return false;
+        if (node.feature >= SNAPSHOT_FEATURE_COUNT) return false;
+        // Children must follow their parent, so every walk ends at a leaf
+        if (node.feature >= 0 && (node.left <= i || node.left >= nodes || node.right <= i || node.right >= nodes)) return false;
+    }
+    return true;
+}
+
+bool ParseMLPModel(std::istream& in, MLModel& model) {
+    if (!(in >> model.inputs >> model.hidden)) return false;
+    if (model.inputs <= 0 || model.inputs > SNAPSHOT_FEATURE_COUNT || model.hidden <= 0) return false;
+    int n = model.inputs, h = model.hidden;
+
+    std::vector<float> norm, w1;
+    if (!ReadModelValues(in, "norm", norm, (size_t)2 * n)) return false;
+    if (!ReadModelValues(in, "w1", w1, (size_t)h * n)) return false;
+    if (!ReadModelValues(in, "b1", model.b1, h)) return false;
+    if (!ReadModelValues(in, "w2", model.w2, h)) return false;
+    std::vector<float> b2;
+    if (!ReadModelValues(in, "b2", b2, 1)) return false;
+    model.b2 = b2[0];
+
+    model.inputMean.resize(n);
+    model.inputInvStd.resize(n);
+    for (int i = 0; i < n; i++) {
+        model.inputMean[i] = norm[2 * i];
+        model.inputInvStd[i] = norm[2 * i + 1] > 0.0f ? 1.0f / norm[2 * i + 1] : 1.0f;
+    }
+
+    model.paddedInputs = (n + ML_INT8_ALIGN - 1) / ML_INT8_ALIGN * ML_INT8_ALIGN;
+    model.w1q.assign((size_t)h * model.paddedInputs, 0);
+    model.w1Scale.resize(h);
+    for (int j = 0; j < h; j++) {
+        model.w1Scale[j] = QuantizeRow(&w1[(size_t)j * n], n, &model.w1q[(size_t)j * model.paddedInputs]);
+    }
+    model.inputQ.assign(model.paddedInputs, 0);
+    model.hiddenOut.assign(h, 0.0f);
+    return true;
+}
+
+// Sum of tree outputs for a batch of rows, one tree at a time
+void ScoreTreeBatch(MLModel& model, const float* rows, int count, double* scores) {
+    for (int r = 0; r < count; r++) scores[r] = model.baseScore;
+    const TreeNode* nodes = model.nodes.data();
+    for (int root : model.roots) {
+        for (int r = 0; r < count; r++) {
+            const float* x = rows + (size_t)r * SNAPSHOT_FEATURE_COUNT;
+            int node = root;
+            while (nodes[node].feature >= 0) {
+                node = x[nodes[node].feature] < nodes[node].threshold ? nodes[node].left : nodes[node].right;
+            }
+            scores[r] += nodes[node].value;
+        }
+    }
+    if (model.logistic) {
+        for (int r = 0; r < count; r++) scores[r] = Sigmoid(scores[r]);
+    }
+}
+
+void ScoreMLPBatch(MLModel& model, const float* rows, int count, double* scores) {
+    int n = model.inputs;
+    float normalized[SNAPSHOT_FEATURE_COUNT];
+    for (int r = 0; r < count; r++) {
+        const float* x = rows + (size_t)r * SNAPSHOT_FEATURE_COUNT;
+        for (int i = 0; i < n; i++) {
+            normalized[i] = (x[i] - model.inputMean[i]) * model.inputInvStd[i];
+        }
+        float inputScale = QuantizeRow(normalized, n, model.inputQ.data());
+
+        double output = model.b2;
+        for (int j = 0; j < model.hidden; j++) {
+            int32_t dot = DotInt8(&model.w1q[(size_t)j * model.paddedInputs], model.inputQ.data(), model.paddedInputs);
+            float activation = dot * inputScale * model.w1Scale[j] + model.b1[j];
+            output += std::max(0.0f, activation) * model.w2[j];
+        }
+        scores[r] = Sigmoid(output);
+    }
+}
+
+void ScoreModelBatch(MLModel& model, const float* rows, int count, double* scores) {
+    if (model.kind == ML_MODEL_GBT) {
+        ScoreTreeBatch(model, rows, count, scores);
+    } else {
+        ScoreMLPBatch(model, rows, count, scores);
+    }
+}
+
+void ResizeMLScores(int count) {
+    for (MLModel& model : mlModels) {
+        model.fleetScores.assign(count, 0.0);
+    }
+}
+
+void UpdateMLScores() {
+    int count = (int)fleet.size();
+    for (MLModel& model : mlModels) {
+        ScoreModelBatch(model, fleetSnapshot.data(), count, model.fleetScores.data());
+    }
+}
+
+// ========================================================================
+// VIBRATION CONDITION INDICATORS
+// ========================================================================
+// Classic time-domain condition indicators per window of vibration samples:
+// RMS, peak, crest factor, kurtosis, skewness and peak-to-peak. The kernel
+// takes samples interleaved as [sample][channel] and makes one pass over
+// them, with each channel in a SIMD lane (blocks of VIB_LANES channels).
+// Power sums are accumulated around the first sample of each channel to
+// keep the single-pass central moments numerically stable.
+//
+// Each step the engine synthesizes one window per axis (X/Y/Z) of every
+// machine with vibration analysis enabled (EnableVibrationAnalysis), from
+// the axis vibration level: 1x and 2x shaft harmonics, broadband noise and
+// bearing-defect impacts that grow with bearing wear. Analyzed machines are
+// packed into slots so the sample buffer only covers subscribers.
+
+const int VIB_FEATURE_RMS = 0;
+const int VIB_FEATURE_PEAK = 1;
+const int VIB_FEATURE_CREST = 2;
+const int VIB_FEATURE_KURTOSIS = 3;
+const int VIB_FEATURE_SKEWNESS = 4;
+const int VIB_FEATURE_PEAK_TO_PEAK = 5;
+const int VIB_FEATURE_COUNT = 6;
+
+const int VIB_AXES = 3;
+const int VIB_LANES = 8;                    // Channels per SIMD block
+const double VIB_SAMPLE_RATE = 2560.0;      // Hz
+const int VIB_DEFAULT_WINDOW = 1024;        // Samples per window (0.4 s)
+const double VIB_BEARING_DEFECT_ORDER = 3.57;  // Outer-race defect frequency / shaft frequency
+const double VIB_TWO_PI = 6.283185307179586;
+
+struct VibrationFeatures {
+    float values[VIB_FEATURE_COUNT];
+};
+
+static int vibrationWindow = VIB_DEFAULT_WINDOW;
+static std::vector<int> vibrationSlot;                    // [machine] -> analyzed slot, -1 when off
+static std::vector<int> vibrationMachines;                // [slot] -> machine
+static std::vector<float> vibrationSamples;               // [sample][slot * 3 + axis]
+static std::vector<VibrationFeatures> vibrationFeatures;  // [slot * 3 + axis]
+static std::mt19937 vibrationGen(12345);                  // Separate stream so physics RNG is untouched
+
+void ComputeVibrationFeatureBlock(const float* samples, int stride, int width, int count, VibrationFeatures* out) {
+    double shift[VIB_LANES], s1[VIB_LANES], s2[VIB_LANES], s3[VIB_LANES], s4[VIB_LANES];
+    float maxValue[VIB_LANES], minValue[VIB_LANES];
+    for (int l = 0; l < width; l++) {
+        shift[l] = samples[l];
+        s1[l] = s2[l] = s3[l] = s4[l] = 0.0;
+        maxValue[l] = minValue[l] = samples[l];
+    }
+
+    for (int s = 0; s < count; s++) {
+        const float* row = samples + (size_t)s * stride;
+        for (int l = 0; l < width; l++) {
+            double y = row[l] - shift[l];
+            double y2 = y * y;
+            s1[l] += y;
+            s2[l] += y2;
+            s3[l] += y2 * y;
+            s4[l] += y2 * y2;
+            maxValue[l] = std::max(maxValue[l], row[l]);
+            minValue[l] = std::min(minValue[l], row[l]);
+        }
+    }
+
+    double n = (double)count;
+    for (int l = 0; l < width; l++) {
+        double k = shift[l];
+        double mu = s1[l] / n;
+        double e2 = s2[l] / n, e3 = s3[l] / n, e4 = s4[l] / n;
+        double m2 = std::max(0.0, e2 - mu * mu);
+        double m3 = e3 - 3.0 * mu * e2 + 2.0 * mu * mu * mu;
+        double m4 = e4 - 4.0 * mu * e3 + 6.0 * mu * mu * e2 - 3.0 * mu * mu * mu * mu;
+        double rms = std::sqrt(std::max(0.0, e2 + 2.0 * k * mu + k * k));
+        double peak = std::max(std::fabs(maxValue[l]), std::fabs(minValue[l]));
+
+        float* v = out[l].values;
+        v[VIB_FEATURE_RMS] = (float)rms;
+        v[VIB_FEATURE_PEAK] = (float)peak;
+        v[VIB_FEATURE_CREST] = rms > 0.0 ? (float)(peak / rms) : 0.0f;
+        v[VIB_FEATURE_KURTOSIS] = m2 > 0.0 ? (float)(m4 / (m2 * m2)) : 0.0f;
+        v[VIB_FEATURE_SKEWNESS] = m2 > 0.0 ? (float)(m3 / (m2 * std::sqrt(m2))) : 0.0f;
+        v[VIB_FEATURE_PEAK_TO_PEAK] = maxValue[l] - minValue[l];
+    }
+}
+
+// samples: [count][channels] interleaved; out: one record per channel
+void ComputeVibrationFeatureSet(const float* samples, int channels, int count, VibrationFeatures* out) {
+    for (int c0 = 0; c0 < channels; c0 += VIB_LANES) {
+        int width = std::min(VIB_LANES, channels - c0);
+        ComputeVibrationFeatureBlock(samples + c0, channels, width, count, out + c0);
+    }
+}
+
+// Cheap approximately normal noise: Irwin-Hall sum of the four 16-bit
+// uniforms in one xorshift64 draw
+static uint64_t vibrationNoiseState = 88172645463325252ull;
+
+float VibrationNoise() {
+    vibrationNoiseState ^= vibrationNoiseState << 13;
+    vibrationNoiseState ^= vibrationNoiseState >> 7;
+    vibrationNoiseState ^= vibrationNoiseState << 17;
+    uint64_t bits = vibrationNoiseState;
+    float sum = (float)((bits & 0xFFFF) + ((bits >> 16) & 0xFFFF) + ((bits >> 32) & 0xFFFF) + (bits >> 48));
+    return (sum * (1.0f / 65536.0f) - 2.0f) * 1.7320508f;
+}
+
+void SynthesizeVibrationWindow(const MotorState& state, int channel, int channels) {
+    float* out = &vibrationSamples[channel];
+    double shaftHz = state.speed / 60.0;
+    if (!state.isRunning || shaftHz <= 0.0) {
+        for (int s = 0; s < vibrationWindow; s++) {
+            for (int axis = 0; axis < VIB_AXES; axis++) out[(size_t)s * channels + axis] = 0.0f;
+        }
+        return;
+    }
+
+    const double axisLevel[VIB_AXES] = { state.vibrationX, state.vibrationY, state.vibrationZ };
+    double dt = 1.0 / VIB_SAMPLE_RATE;
+    double impactPeriod = 1.0 / (shaftHz * VIB_BEARING_DEFECT_ORDER);
+
+    // Harmonic amplitudes chosen so the window RMS tracks the axis level
+    double fundamental[VIB_AXES], second[VIB_AXES], noiseLevel[VIB_AXES], impactLevel[VIB_AXES];
+    double shaftRe[VIB_AXES], shaftIm[VIB_AXES];
+    for (int axis = 0; axis < VIB_AXES; axis++) {
+        double amplitude = axisLevel[axis] * std::sqrt(2.0);
+        fundamental[axis] = 0.85 * amplitude;
+        second[axis] = 2.0 * 0.35 * amplitude;  // sin(2a) = 2 sin(a) cos(a)
+        noiseLevel[axis] = 0.2 * axisLevel[axis];
+        impactLevel[axis] = 4.0 * axisLevel[axis] * state.bearingWear;
+        double phase = VIB_TWO_PI * (vibrationGen() % 1000) / 1000.0;
+        shaftRe[axis] = std::cos(phase);
+        shaftIm[axis] = std::sin(phase);
+    }
+
+    // Phasor recurrences replace per-sample sin/exp: the shaft phasor
+    // rotates each sample, the bearing ring-down rotates and decays
+    double shaftCos = std::cos(VIB_TWO_PI * shaftHz * dt), shaftSin = std::sin(VIB_TWO_PI * shaftHz * dt);
+    double ringDecay = std::exp(-800.0 * dt);
+    double ringCos = std::cos(VIB_TWO_PI * 900.0 * dt) * ringDecay, ringSin = std::sin(VIB_TWO_PI * 900.0 * dt) * ringDecay;
+    double ringRe = 1.0, ringIm = 0.0, sinceImpact = 0.0;
+
+    for (int s = 0; s < vibrationWindow; s++) {
+        float* row = out + (size_t)s * channels;
+        for (int axis = 0; axis < VIB_AXES; axis++) {
+            double value = shaftIm[axis] * (fundamental[axis] + second[axis] * shaftRe[axis]);
+            value += noiseLevel[axis] * VibrationNoise();
+            value += impactLevel[axis] * ringIm;
+            row[axis] = (float)value;
+
+            double re = shaftRe[axis] * shaftCos - shaftIm[axis] * shaftSin;
+            shaftIm[axis] = shaftRe[axis] * shaftSin + shaftIm[axis] * shaftCos;
+            shaftRe[axis] = re;
+        }
+
+        double re = ringRe * ringCos - ringIm * ringSin;
+        ringIm = ringRe * ringSin + ringIm * ringCos;
+        ringRe = re;
+        sinceImpact += dt;
+        if (sinceImpact >= impactPeriod) {
+            // Next defect impact restarts the ring-down
+            sinceImpact -= impactPeriod;
+            double decay = std::exp(-800.0 * sinceImpact);
+            ringRe = decay * std::cos(VIB_TWO_PI * 900.0 * sinceImpact);
+            ringIm = decay * std::sin(VIB_TWO_PI * 900.0 * sinceImpact);
+        }
+    }
+}
+
+// Size the window buffers for the current subscribers
+void AllocateVibrationBuffers() {
+    size_t slots = vibrationMachines.size();
+    vibrationSamples.assign((size_t)vibrationWindow * slots * VIB_AXES, 0.0f);
+    vibrationFeatures.assign(slots * VIB_AXES, VibrationFeatures{});
+}
+
+void ResizeVibrationFeatures(int count) {
+    vibrationSlot.assign(count, -1);
+    vibrationMachines.clear();
+    AllocateVibrationBuffers();
+}
+
+// Add or remove a machine from the analyzed set; the last slot fills a gap
+void SetVibrationAnalysis(int index, bool enabled) {
+    int slot = vibrationSlot[index];
+    if (enabled == (slot >= 0)) return;
+    if (enabled) {
+        vibrationSlot[index] = (int)vibrationMachines.size();
+        vibrationMachines.push_back(index);
+    } else {
+        int moved = vibrationMachines.back();
+        vibrationMachines[slot] = moved;
+        vibrationSlot[moved] = slot;
+        vibrationMachines.pop_back();
+        vibrationSlot[index] = -1;
+    }
+    AllocateVibrationBuffers();
+}
+
+void UpdateVibrationFeatures() {
+    int slots = (int)vibrationMachines.size();
+    if (slots == 0) return;
+    int channels = slots * VIB_AXES;
+    for (int slot = 0; slot < slots; slot++) {
+        SynthesizeVibrationWindow(fleet[vibrationMachines[slot]], slot * VIB_AXES, channels);
+    }
+    ComputeVibrationFeatureSet(vibrationSamples.data(), channels, vibrationWindow, vibrationFeatures.data());
+}
+
+// ========================================================================
+// SNAPSHOT HISTORY
+// ========================================================================
+// Ring buffer of fleet snapshot rows, one [machine][feature] frame per
+// step, used as training data for native models. Recording is off until
+// SetSnapshotHistoryCapacity opts in (a frame is a full fleet snapshot);
+// storage then grows with the frames recorded rather than being reserved
+// for the whole capacity, and a capacity of 0 turns recording off again.
+
+const int DEFAULT_HISTORY_CAPACITY = 0;    // Steps - Off until requested
+const int HISTORY_INITIAL_FRAMES = 16;     // First allocation; doubles up to the capacity
+
+static int historyCapacity = DEFAULT_HISTORY_CAPACITY;
+static std::vector<float> snapshotHistory;  // [frame][machine][feature]
+static int historyFrames = 0;               // Frames allocated
+static int historyHead = 0;                 // Next frame slot
+static int historyLength = 0;               // Frames stored
+
+void ResetSnapshotHistory() {
+    std::vector<float>().swap(snapshotHistory);
+    historyFrames = 0;
+    historyHead = 0;
+    historyLength = 0;
+}
+
+void UpdateSnapshotHistory() {
+    size_t frame = fleetSnapshot.size();
+    if (historyCapacity == 0 || frame == 0) return;
+    if (historyHead == historyFrames && historyFrames < historyCapacity) {
+        // Not wrapped yet, so the frames held are in order and can be grown in place
+        int frames = std::min(historyCapacity, std::max(HISTORY_INITIAL_FRAMES, historyFrames * 2));
+        try {
+            snapshotHistory.resize((size_t)frames * frame);
+            historyFrames = frames;
+        } catch (const std::bad_alloc&) {
+            // Out of memory: keep wrapping over the frames already held
+            if (historyFrames == 0) return;
+            historyCapacity = historyFrames;
+            historyHead = 0;
+        }
+    }
+    std::copy(fleetSnapshot.begin(), fleetSnapshot.end(), snapshotHistory.begin() + (size_t)historyHead * frame);
+    historyHead = (historyHead + 1) % historyCapacity;
+    historyLength = std::min(historyLength + 1, historyCapacity);
+}
+
+// Snapshot row for machine at age 0 (oldest) .. historyLength-1 (newest)
+const float* HistoryRow(int age, int machine) {
+    int slot = (historyHead - historyLength + age + historyCapacity) % historyCapacity;
+    return &snapshotHistory[((size_t)slot * fleet.size() + machine) * SNAPSHOT_FEATURE_COUNT];
+}
+
+// ========================================================================
+// ISOLATION FOREST
+// ========================================================================
+// Unsupervised anomaly model trained on running-machine rows sampled from
+// the snapshot history. Each tree is stored in pre-order in one flat node
+// array: the left child directly follows its parent and only the right
+// child index is kept. Leaves store their full path length (depth plus
+// the c(n) correction for the rows left unsplit), looked up from a table
+// built once per training run, so scoring is a pure descent.
+//
+// Score = 2^(-E[h(x)] / c(sampleSize)); ~0.5 is normal, towards 1 is anomalous.
+
+const int DEFAULT_ISOLATION_TREES = 100;
+const int DEFAULT_ISOLATION_SAMPLE = 256;
+
+struct IsolationNode {
+    int feature;       // -1 for leaves
+    float threshold;
+    int right;         // Right child; left child is the next node
+    float pathLength;  // Leaves: depth + c(size)
+};
+
+static std::vector<IsolationNode> isolationNodes;
+static std::vector<int> isolationRoots;
+static std::vector<float> isolationPathTable;  // c(n) for n = 0..sampleSize
+static double isolationNormalizer = 1.0;       // c(sampleSize)
+static std::vector<double> isolationScores;    // Per machine, refreshed every step
+static std::mt19937 isolationGen(2024);
+
+// Average unsuccessful-search path length in a BST of n rows
+double IsolationAveragePath(int n) {
+    if (n <= 1) return 0.0;
+    if (n == 2) return 1.0;
+    return 2.0 * (std::log(n - 1.0) + 0.5772156649) - 2.0 * (n - 1.0) / n;
+}
+
+void BuildIsolationNode(const std::vector<float>& rows, int* indices, int count, int depth, int maxDepth) {
+    int node = (int)isolationNodes.size();
+    isolationNodes.push_back(IsolationNode{ -1, 0.0f, -1, 0.0f });
+
+    if (count > 1 && depth < maxDepth) {
+        // Pick a feature that still varies within this node
+        int feature = -1;
+        float lo = 0.0f, hi = 0.0f;
+        for (int attempt = 0; attempt < SNAPSHOT_FEATURE_COUNT && feature < 0; attempt++) {
+            int f = isolationGen() % SNAPSHOT_FEATURE_COUNT;
+            lo = hi = rows[(size_t)indices[0] * SNAPSHOT_FEATURE_COUNT + f];
+            for (int i = 1; i < count; i++) {
+                float v = rows[(size_t)indices[i] * SNAPSHOT_FEATURE_COUNT + f];
+                lo = std::min(lo, v);
+                hi = std::max(hi, v);
+            }
+            if (hi > lo) feature = f;
+        }
+        if (feature >= 0) {
+            std::uniform_real_distribution<float> split(lo, hi);
+            float threshold = split(isolationGen);
+            int* middle = std::partition(indices, indices + count, [&](int row) {
+                return rows[(size_t)row * SNAPSHOT_FEATURE_COUNT + feature] < threshold;
+            });
+            int leftCount = (int)(middle - indices);
+            isolationNodes[node].feature = feature;
+            isolationNodes[node].threshold = threshold;
+            BuildIsolationNode(rows, indices, leftCount, depth + 1, maxDepth);
+            isolationNodes[node].right = (int)isolationNodes.size();
+            BuildIsolationNode(rows, middle, count - leftCount, depth + 1, maxDepth);
+            return;
+        }
+    }
+    isolationNodes[node].pathLength = depth + isolationPathTable[count];
+}
+
+void ScoreIsolationRows(const float* rows, int count, double* scores) {
+    for (int r = 0; r < count; r++) scores[r] = 0.0;
+    const IsolationNode* nodes = isolationNodes.data();
+    for (int root : isolationRoots) {
+        for (int r = 0; r < count; r++) {
+            const float* x = rows + (size_t)r * SNAPSHOT_FEATURE_COUNT;
+            int node = root;
+            while (nodes[node].feature >= 0) {
+                node = x[nodes[node].feature] < nodes[node].threshold ? node + 1 : nodes[node].right;
+            }
+            scores[r] += nodes[node].pathLength;
+        }
+    }
+    double scale = 1.0 / (isolationRoots.size() * isolationNormalizer);
+    for (int r = 0; r < count; r++) {
+        scores[r] = std::pow(2.0, -scores[r] * scale);
+    }
+}
+
+// Returns false when the history holds too few running rows
+bool TrainIsolationForestFromHistory(int trees, int sampleSize) {
+    std::vector<float> candidates;
+    for (int age = 0; age < historyLength; age++) {
+        for (int i = 0; i < (int)fleet.size(); i++) {
+            const float* row = HistoryRow(age, i);
+            if (row[11] <= 0.0f) continue;  // Stopped machines are not representative
+            candidates.insert(candidates.end(), row, row + SNAPSHOT_FEATURE_COUNT);
+        }
+    }
+    int available = (int)(candidates.size() / SNAPSHOT_FEATURE_COUNT);
+    if (available < 2) return false;
+    sampleSize = std::min(sampleSize, available);
+
+    isolationPathTable.resize(sampleSize + 1);
+    for (int n = 0; n <= sampleSize; n++) isolationPathTable[n] = (float)IsolationAveragePath(n);
+    isolationNormalizer = std::max(1.0, IsolationAveragePath(sampleSize));
+    int maxDepth = (int)std::ceil(std::log2((double)sampleSize));
+
+    isolationNodes.clear();
+    isolationRoots.clear();
+    std::vector<int> all(available), sample(sampleSize);
+    for (int r = 0; r < available; r++) all[r] = r;
+    for (int t = 0; t < trees; t++) {
+        // Partial Fisher-Yates draw without replacement
+        for (int k = 0; k < sampleSize; k++) {
+            int pick = k + (int)(isolationGen() % (available - k));
+            std::swap(all[k], all[pick]);
+            sample[k] = all[k];
+        }
+        isolationRoots.push_back((int)isolationNodes.size());
+        BuildIsolationNode(candidates, sample.data(), sampleSize, 0, maxDepth);
+    }
+    return true;
+}
+
+void ResizeIsolationScores(int count) {
+    isolationScores.assign(count, 0.0);
+}
+
+void UpdateIsolationScores() {
+    if (isolationRoots.empty()) return;
+    ScoreIsolationRows(fleetSnapshot.data(), (int)fleet.size(), isolationScores.data());
+}
+
+// ========================================================================
+// MATRIX PROFILE (motifs and discords)
+// ========================================================================
+// Exact self-join matrix profile (z-normalized Euclidean distance) in the
+// STOMP/SCAMP style: each diagonal's sliding dot products are updated in
+// O(1) per step, MP_LANES neighbouring diagonals are advanced together so
+// the inner loop vectorizes, and blocks of diagonals are spread over
+// worker threads that keep private profiles merged at the end. The series
+// is centred on its mean first to limit cancellation in the dot products.
+//
+// Work is O(n^2 / 2): ~10^5 points take seconds; longer recordings should
+// be downsampled before the join.
+
+const int MP_LANES = 16;  // Diagonals advanced together
+
+static std::vector<double> matrixProfile;      // Distance to nearest non-trivial match
+static std::vector<int> matrixProfileIndex;    // Position of that match
+static int matrixProfileWindow = 0;
+
+// Advance `lanes` diagonals starting at column j0 by one row i; called with
+// lanes == MP_LANES on the hot path so the lane loops have a fixed trip count
+inline void MatrixProfileRow(const double* t, const double* mean, const double* invStd, int window,
+                             int i, int j0, int lanes, double* qt, double* bestCorr, double* bestIndex) {
+    if (i > 0) {
+        // Slide every diagonal by one sample
+        double outA = t[i - 1], inA = t[i + window - 1];
+        for (int l = 0; l < lanes; l++) {
+            qt[l] += inA * t[j0 + l + window - 1] - outA * t[j0 + l - 1];
+        }
+    }
+    double rowScale = invStd[i] / window, rowMean = window * mean[i];
+    double position = (double)i, rowCurrent = bestCorr[i];
+    double corr[MP_LANES];
+    int rowImproved = 0;
+    for (int l = 0; l < lanes; l++) {
+        double c = (qt[l] - rowMean * mean[j0 + l]) * rowScale * invStd[j0 + l];
+        // Branch-free column update so the lane loop vectorizes;
+        // positions are held as doubles to keep both selects the same width
+        double previous = bestCorr[j0 + l], previousAt = bestIndex[j0 + l];
+        corr[l] = c;
+        bestCorr[j0 + l] = c > previous ? c : previous;
+        bestIndex[j0 + l] = c > previous ? position : previousAt;
+        rowImproved |= c > rowCurrent;
+    }
+    // Row side needs a reduction over lanes; it rarely improves once warmed up
+    if (rowImproved) {
+        for (int l = 0; l < lanes; l++) {
+            if (corr[l] > bestCorr[i]) {
+                bestCorr[i] = corr[l];
+                bestIndex[i] = j0 + l;
+            }
+        }
+    }
+}
+
+void ComputeMatrixProfileDiagonals(const std::vector<double>& t, const std::vector<double>& mean,
+                                   const std::vector<double>& invStd, int window, int exclusion,
+                                   int firstBlock, int blockStride,
+                                   std::vector<double>& bestCorr, std::vector<double>& bestIndex) {
+    int count = (int)mean.size();
+    double qt[MP_LANES];
+    for (int k0 = exclusion + firstBlock * MP_LANES; k0 < count; k0 += blockStride * MP_LANES) {
+        int width = std::min(MP_LANES, count - k0);
+        for (int l = 0; l < width; l++) {
+            double dot = 0.0;
+            for (int s = 0; s < window; s++) dot += t[s] * t[k0 + l + s];
+            qt[l] = dot;
+        }
+
+        for (int i = 0; i < count - k0; i++) {
+            int lanes = std::min(width, count - k0 - i);
+            if (lanes == MP_LANES) {
+                MatrixProfileRow(t.data(), mean.data(), invStd.data(), window, i, i + k0, MP_LANES,
+                                 qt, bestCorr.data(), bestIndex.data());
+            } else {
+                MatrixProfileRow(t.data(), mean.data(), invStd.data(), window, i, i + k0, lanes,
+                                 qt, bestCorr.data(), bestIndex.data());
+            }
+        }
+    }
+}
+
+// Returns the number of subsequences profiled, 0 if the series is too short
+int RunMatrixProfile(const double* series, int length, int window) {
+    matrixProfile.clear();
+    matrixProfileIndex.clear();
+    matrixProfileWindow = window;
+    if (series == nullptr || window < 4 || length < 2 * window) return 0;
+
+    int count = length - window + 1;
+    int exclusion = std::max(1, window / 4);
+    if (exclusion >= count) return 0;
+
+    double seriesMean = 0.0;
+    for (int s = 0; s < length; s++) seriesMean += series[s];
+    seriesMean /= length;
+    std::vector<double> t(length);
+    for (int s = 0; s < length; s++) t[s] = series[s] - seriesMean;
+
+    // Rolling subsequence mean and 1/std (0 for flat subsequences)
+    std::vector<double> mean(count), invStd(count);
+    double sum = 0.0, sumSq = 0.0;
+    for (int s = 0; s < length; s++) {
+        sum += t[s];
+        sumSq += t[s] * t[s];
+        if (s >= window) {
+            sum -= t[s - window];
+            sumSq -= t[s - window] * t[s - window];
+        }
+        if (s >= window - 1) {
+            int i = s - window + 1;
+            mean[i] = sum / window;
+            double variance = sumSq / window - mean[i] * mean[i];
+            invStd[i] = variance > 1e-12 ? 1.0 / std::sqrt(variance) : 0.0;
+        }
+    }
+
+    int blocks = (count - exclusion + MP_LANES - 1) / MP_LANES;
+    int workers = (int)std::max(1u, std::thread::hardware_concurrency());
+    workers = std::max(1, std::min(workers, blocks / 4));
+
+    std::vector<std::vector<double>> corr(workers, std::vector<double>(count, -INFINITY));
+    std::vector<std::vector<double>> index(workers, std::vector<double>(count, -1.0));
+    std::vector<std::thread> threads;
+    for (int w = 1; w < workers; w++) {
+        threads.emplace_back(ComputeMatrixProfileDiagonals, std::cref(t), std::cref(mean), std::cref(invStd),
+                             window, exclusion, w, workers, std::ref(corr[w]), std::ref(index[w]));
+    }
+    ComputeMatrixProfileDiagonals(t, mean, invStd, window, exclusion, 0, workers, corr[0], index[0]);
+    for (std::thread& thread : threads) thread.join();
+
+    // Merge keeping the lowest match position on ties so results do not depend on thread count
+    matrixProfile.resize(count);
+    matrixProfileIndex.resize(count);
+    for (int i = 0; i < count; i++) {
+        double best = corr[0][i];
+        int bestAt = (int)index[0][i];
+        for (int w = 1; w < workers; w++) {
+            int at = (int)index[w][i];
+            if (corr[w][i] > best || (corr[w][i] == best && at >= 0 && (bestAt < 0 || at < bestAt))) {
+                best = corr[w][i];
+                bestAt = at;
+            }
+        }
+        matrixProfile[i] = std::sqrt(std::max(0.0, 2.0 * window * (1.0 - std::min(1.0, best))));
+        matrixProfileIndex[i] = bestAt;
+    }
+    return count;
+}
+
+// Positions ordered by profile value, skipping trivial matches of earlier picks
+int SelectMatrixProfileExtremes(bool largest, int k, int* positions, int* neighbors, double* distances) {
+    int count = (int)matrixProfile.size();
+    std::vector<int> order(count);
+    for (int i = 0; i < count; i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return largest ? matrixProfile[a] > matrixProfile[b] : matrixProfile[a] < matrixProfile[b];
+    });
+
+    int found = 0;
+    for (int candidate : order) {
+        if (found >= k) break;
+        if (matrixProfileIndex[candidate] < 0) continue;
+        bool trivial = false;
+        for (int f = 0; f < found && !trivial; f++) {
+            trivial = std::abs(candidate - positions[f]) < matrixProfileWindow ||
+                      (neighbors != nullptr && std::abs(candidate - neighbors[f]) < matrixProfileWindow);
+        }
+        if (trivial) continue;
+        positions[found] = candidate;
+        if (neighbors != nullptr) neighbors[found] = matrixProfileIndex[candidate];
+        if (distances != nullptr) distances[found] = matrixProfile[candidate];
+        found++;
+    }
+    return found;
+}
+
+// ========================================================================
+// CHANGE-POINT DETECTION (PELT)
+// ========================================================================
+// Offline segmentation of a channel into pieces with constant mean (cost
+// model 0) or constant mean and variance (cost model 1). Segment costs are
+// O(1) from prefix sums of x and x^2. Two searches share them:
+//   PELT (method 0): exact optimum; pruning keeps it near-linear when
+//     segments are short, but candidates grow with segment length.
+//   Binary segmentation (method 1): greedy best split per segment,
+//     O(n log n); the choice for recordings with millions of points.
+// Fleet runs segment one snapshot feature of every machine's recorded
+// history, spreading machines over worker threads.
+//
+// Mean model: squared error scaled by a robust noise variance (MAD of
+// first differences). Mean/variance model: Gaussian likelihood n*log(var).
+// A penalty <= 0 selects BIC (2 log n for mean, 3 log n for mean/variance).
+
+const int CHANGE_METHOD_PELT = 0;
+const int CHANGE_METHOD_BINARY = 1;
+const int CHANGE_COST_MEAN = 0;
+const int CHANGE_COST_MEAN_VARIANCE = 1;
+const int DEFAULT_MIN_SEGMENT = 5;
+
+struct ChangeSegment {
+    int start, end;   // [start, end) sample positions
+    double mean, stdDev;
+};
+
+static std::vector<std::vector<ChangeSegment>> machineSegments;
+
+void SegmentSeries(const double* series, int length, int method, int costModel, double penalty, int minSegment,
+                   std::vector<ChangeSegment>& segments) {
+    segments.clear();
+    if (series == nullptr || length <= 0) return;
+    minSegment = std::max(2, minSegment);
+
+    std::vector<double> s1(length + 1, 0.0), s2(length + 1, 0.0);
+    double shift = series[0];  // Centre sums for precision
+    for (int i = 0; i < length; i++) {
+        double x = series[i] - shift;
+        s1[i + 1] = s1[i] + x;
+        s2[i + 1] = s2[i] + x * x;
+    }
+
+    double totalVar = std::max(0.0, s2[length] / length - (s1[length] / length) * (s1[length] / length));
+    double varFloor = 1e-8 * totalVar + 1e-12;
+    double noiseVar = 1.0;
+    if (costModel == CHANGE_COST_MEAN && length > 2) {
+        std::vector<double> diffs(length - 1);
+        for (int i = 1; i < length; i++) diffs[i - 1] = std::fabs(series[i] - series[i - 1]);
+        std::nth_element(diffs.begin(), diffs.begin() + diffs.size() / 2, diffs.end());
+        double sigma = diffs[diffs.size() / 2] / (0.6745 * std::sqrt(2.0));
+        noiseVar = std::max(sigma * sigma, varFloor);
+    }
+    if (penalty <= 0.0) {
+        penalty = (costModel == CHANGE_COST_MEAN ? 2.0 : 3.0) * std::log((double)length);
+    }
+
+    auto cost = [&](int a, int b) {
+        double n = b - a;
+        double sum = s1[b] - s1[a];
+        double squared = s2[b] - s2[a] - sum * sum / n;
+        if (costModel == CHANGE_COST_MEAN) return squared / noiseVar;
+        return n * std::log(std::max(squared / n, varFloor));
+    };
+
+    // previous[end]: start of the segment ending at end
+    std::vector<int> previous(length + 1, 0);
+    if (method == CHANGE_METHOD_BINARY) {
+        std::vector<int> boundaries = { 0, length };
+        std::vector<std::pair<int, int>> pending = { { 0, length } };
+        while (!pending.empty()) {
+            auto [a, b] = pending.back();
+            pending.pop_back();
+            double whole = cost(a, b);
+            double bestGain = penalty;
+            int bestSplit = -1;
+            for (int k = a + minSegment; k <= b - minSegment; k++) {
+                double gain = whole - cost(a, k) - cost(k, b);
+                if (gain > bestGain) {
+                    bestGain = gain;
+                    bestSplit = k;
+                }
+            }
+            if (bestSplit < 0) continue;
+            boundaries.push_back(bestSplit);
+            pending.push_back({ a, bestSplit });
+            pending.push_back({ bestSplit, b });
+        }
+        std::sort(boundaries.begin(), boundaries.end());
+        for (size_t k = 1; k < boundaries.size(); k++) previous[boundaries[k]] = boundaries[k - 1];
+    } else {
+        // best[t]: optimal cost of series[0, t)
+        std::vector<double> best(length + 1, INFINITY);
+        std::vector<int> candidates;
+        candidates.reserve(64);
+        best[0] = -penalty;
+        candidates.push_back(0);
+        for (int t = minSegment; t <= length; t++) {
+            if (t - minSegment >= minSegment) candidates.push_back(t - minSegment);
+            double bestCost = INFINITY;
+            int bestStart = 0;
+            for (int s : candidates) {
+                double value = best[s] + cost(s, t) + penalty;
+                if (value < bestCost) {
+                    bestCost = value;
+                    bestStart = s;
+                }
+            }
+            best[t] = bestCost;
+            previous[t] = bestStart;
+
+            // PELT pruning: a start that cannot beat F[t] now never will
+            size_t kept = 0;
+            for (int s : candidates) {
+                if (best[s] + cost(s, t) <= bestCost) candidates[kept++] = s;
+            }
+            candidates.resize(kept);
+        }
+        if (length < minSegment) previous[length] = 0;
+    }
+
+    for (int end = length; end > 0; end = previous[end]) {
+        int start = previous[end];
+        double n = end - start;
+        double mean = (s1[end] - s1[start]) / n;
+        double variance = std::max(0.0, (s2[end] - s2[start]) / n - mean * mean);
+        segments.push_back(ChangeSegment{ start, end, mean + shift, std::sqrt(variance) });
+    }
+    std::reverse(segments.begin(), segments.end());
+}
+
+void SegmentMachineHistory(int index, int feature, int method, int costModel, double penalty, int minSegment) {
+    std::vector<double> series(historyLength);
+    for (int age = 0; age < historyLength; age++) {
+        series[age] = HistoryRow(age, index)[feature];
+    }
+    SegmentSeries(series.data(), historyLength, method, costModel, penalty, minSegment, machineSegments[index]);
+}
+
+void SegmentFleetHistory(int feature, int method, int costModel, double penalty, int minSegment) {
+    int count = (int)fleet.size();
+    machineSegments.resize(count);
+    int workers = (int)std::max(1u, std::thread::hardware_concurrency());
+    workers = std::max(1, std::min(workers, count));
+
+    auto work = [&](int first) {
+        for (int i = first; i < count; i += workers) {
+            SegmentMachineHistory(i, feature, method, costModel, penalty, minSegment);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int w = 1; w < workers; w++) threads.emplace_back(work, w);
+    work(0);
+    for (std::thread& thread : threads) thread.join();
+}
+
+int CopySegments(const std::vector<ChangeSegment>& segments, int* starts, int* ends, double* means, double* stdDevs, int maxSegments) {
+    int count = std::min((int)segments.size(), maxSegments);
+    for (int k = 0; k < count; k++) {
+        if (starts != nullptr) starts[k] = segments[k].start;
+        if (ends != nullptr) ends[k] = segments[k].end;
+        if (means != nullptr) means[k] = segments[k].mean;
+        if (stdDevs != nullptr) stdDevs[k] = segments[k].stdDev;
+    }
+    return count;
+}
+
+// ========================================================================
+// SPECTRAL SIGNATURE SEARCH
+// ========================================================================
+// Each step, the X/Y/Z vibration windows of every running machine with
+// vibration analysis enabled (EnableVibrationAnalysis) are reduced to
+// SPECTRAL_BANDS log-spaced band amplitudes (radix-2 FFT), normalized
+// to unit length and appended to a ring of signatures tagged with machine
+// and simulation time. One signature is exactly one 64-byte row, so the
+// brute-force cosine scan is a fixed-length dot product per row.
+//
+// For large stores an IVF index (spherical k-means coarse lists) limits a
+// query to the entries of its nprobe closest lists. Entries added after a
+// build are assigned to their list on insert, and a ring slot leaves its
+// list when it is overwritten, so the lists never hold more than the ring.
+
+const int SPECTRAL_BANDS = 16;
+const double SPECTRAL_MIN_FREQUENCY = 10.0;      // Hz - Lower edge of the first band
+const int DEFAULT_SPECTRAL_CAPACITY = 65536;     // Stored signatures
+
+struct alignas(64) SpectralSignature {
+    float bands[SPECTRAL_BANDS];
+};
+
+struct SpectralEntry {
+    int machine;
+    double time;
+};
+
+static int spectralCapacity = DEFAULT_SPECTRAL_CAPACITY;
+static std::vector<SpectralSignature> spectralSignatures;  // Ring [slot]
+static std::vector<SpectralEntry> spectralEntries;         // Ring [slot]
+static uint64_t spectralInserted = 0;
+static std::vector<SpectralSignature> machineSpectra;      // Latest per machine
+
+// FFT scratch, sized for the vibration window
+static int spectralFFTSize = 0;
+static std::vector<double> fftRe, fftIm, fftCos, fftSin, spectralPower;
+static std::vector<int> spectralBandStart;                 // First bin per band, plus end sentinel
+
+// IVF coarse quantizer
+static std::vector<SpectralSignature> spectralCentroids;
+static std::vector<std::vector<int>> spectralLists;        // Slots per list
+static std::vector<int> spectralSlotList;                  // [slot] -> list, -1 when unlisted
+static std::vector<int> spectralSlotPosition;              // [slot] -> index within its list
+
+float SpectralDot(const SpectralSignature& a, const SpectralSignature& b) {
+    // Four partial sums so the compiler can keep lanes independent
+    float partial[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int k = 0; k < SPECTRAL_BANDS; k += 4) {
+        for (int l = 0; l < 4; l++) partial[l] += a.bands[k + l] * b.bands[k + l];
+    }
+    return (partial[0] + partial[1]) + (partial[2] + partial[3]);
+}
+
+void NormalizeSignature(SpectralSignature& signature) {
+    float norm = std::sqrt(SpectralDot(signature, signature));
+    float scale = norm > 0.0f ? 1.0f / norm : 0.0f;
+    for (int k = 0; k < SPECTRAL_BANDS; k++) signature.bands[k] *= scale;
+}
+
+// Largest power of two that fits in the vibration window
+int SpectralFFTSizeFor(int window) {
+    int size = 1;
+    while (size * 2 <= window) size *= 2;
+    return size;
+}
+
+void PrepareSpectralFFT() {
+    int size = SpectralFFTSizeFor(vibrationWindow);
+    spectralFFTSize = size;
+    fftRe.assign(size, 0.0);
+    fftIm.assign(size, 0.0);
+    spectralPower.assign(size / 2, 0.0);
+    fftCos.resize(size / 2);
+    fftSin.resize(size / 2);
+    for (int k = 0; k < size / 2; k++) {
+        fftCos[k] = std::cos(VIB_TWO_PI * k / size);
+        fftSin[k] = -std::sin(VIB_TWO_PI * k / size);
+    }
+
+    // Log-spaced band edges from SPECTRAL_MIN_FREQUENCY to Nyquist, at least one bin each
+    double binHz = VIB_SAMPLE_RATE / size;
+    double ratio = std::pow((VIB_SAMPLE_RATE / 2.0) / SPECTRAL_MIN_FREQUENCY, 1.0 / SPECTRAL_BANDS);
+    spectralBandStart.resize(SPECTRAL_BANDS + 1);
+    double edge = SPECTRAL_MIN_FREQUENCY;
+    for (int b = 0; b <= SPECTRAL_BANDS; b++) {
+        int bin = std::min(size / 2, (int)std::lround(edge / binHz));
+        if (b > 0) bin = std::max(bin, std::min(size / 2, spectralBandStart[b - 1] + 1));
+        spectralBandStart[b] = bin;
+        edge *= ratio;
+    }
+    spectralBandStart[SPECTRAL_BANDS] = size / 2;
+}
+
+// In-place iterative radix-2 FFT over fftRe/fftIm
+void RunSpectralFFT() {
+    int n = spectralFFTSize;
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            std::swap(fftRe[i], fftRe[j]);
+            std::swap(fftIm[i], fftIm[j]);
+        }
+    }
+    for (int length = 2; length <= n; length <<= 1) {
+        int half = length / 2, step = n / length;
+        for (int start = 0; start < n; start += length) {
+            for (int k = 0; k < half; k++) {
+                double wr = fftCos[k * step], wi = fftSin[k * step];
+                int a = start + k, b = a + half;
+                double re = fftRe[b] * wr - fftIm[b] * wi;
+                double im = fftRe[b] * wi + fftIm[b] * wr;
+                fftRe[b] = fftRe[a] - re;
+                fftIm[b] = fftIm[a] - im;
+                fftRe[a] += re;
+                fftIm[a] += im;
+            }
+        }
+    }
+}
+
+void ComputeSpectralSignature(int slot, SpectralSignature& signature) {
+    int channels = (int)vibrationMachines.size() * VIB_AXES;
+    int n = spectralFFTSize;
+    std::fill(spectralPower.begin(), spectralPower.end(), 0.0);
+    for (int axis = 0; axis < VIB_AXES; axis++) {
+        const float* samples = &vibrationSamples[(size_t)slot * VIB_AXES + axis];
+        for (int s = 0; s < n; s++) {
+            fftRe[s] = samples[(size_t)s * channels];
+            fftIm[s] = 0.0;
+        }
+        RunSpectralFFT();
+        for (int k = 0; k < n / 2; k++) {
+            spectralPower[k] += fftRe[k] * fftRe[k] + fftIm[k] * fftIm[k];
+        }
+    }
+    for (int b = 0; b < SPECTRAL_BANDS; b++) {
+        double energy = 0.0;
+        for (int k = spectralBandStart[b]; k < spectralBandStart[b + 1]; k++) energy += spectralPower[k];
+        signature.bands[b] = (float)std::sqrt(energy);
+    }
+    NormalizeSignature(signature);
+}
+
+int NearestSpectralCentroid(const SpectralSignature& signature) {
+    int best = 0;
+    float bestDot = -INFINITY;
+    for (int c = 0; c < (int)spectralCentroids.size(); c++) {
+        float dot = SpectralDot(signature, spectralCentroids[c]);
+        if (dot > bestDot) {
+            bestDot = dot;
+            best = c;
+        }
+    }
+    return best;
+}
+
+void ListSpectralSlot(int slot, int list) {
+    spectralSlotList[slot] = list;
+    spectralSlotPosition[slot] = (int)spectralLists[list].size();
+    spectralLists[list].push_back(slot);
+}
+
+// O(1) removal: the list's last slot takes the vacated position
+void UnlistSpectralSlot(int slot) {
+    int list = spectralSlotList[slot];
+    if (list < 0) return;
+    std::vector<int>& members = spectralLists[list];
+    int position = spectralSlotPosition[slot];
+    int moved = members.back();
+    members[position] = moved;
+    spectralSlotPosition[moved] = position;
+    members.pop_back();
+    spectralSlotList[slot] = -1;
+}
+
+void InsertSpectralSignature(int machine, const SpectralSignature& signature) {
+    int slot = (int)(spectralInserted % spectralCapacity);
+    UnlistSpectralSlot(slot);
+    spectralSignatures[slot] = signature;
+    spectralEntries[slot] = SpectralEntry{ machine, fleetSimTime };
+    if (!spectralCentroids.empty()) {
+        ListSpectralSlot(slot, NearestSpectralCentroid(signature));
+    }
+    spectralInserted++;
+}
+
+void ResizeSpectralSignatures(int count) {
+    spectralSignatures.assign(spectralCapacity, SpectralSignature{});
+    spectralEntries.assign(spectralCapacity, SpectralEntry{ -1, 0.0 });
+    spectralInserted = 0;
+    spectralCentroids.clear();
+    spectralLists.clear();
+    spectralSlotList.assign(spectralCapacity, -1);
+    spectralSlotPosition.assign(spectralCapacity, 0);
+    machineSpectra.assign(count, SpectralSignature{});
+    PrepareSpectralFFT();
+}
+
+// Signatures come from the vibration windows, so only analyzed machines
+// contribute to the store
+void UpdateSpectralSignatures() {
+    if (spectralFFTSize != SpectralFFTSizeFor(vibrationWindow)) PrepareSpectralFFT();
+    for (int slot = 0; slot < (int)vibrationMachines.size(); slot++) {
+        int i = vibrationMachines[slot];
+        if (!fleet[i].isRunning) {
+            machineSpectra[i] = SpectralSignature{};
+            continue;
+        }
+        ComputeSpectralSignature(slot, machineSpectra[i]);
+        InsertSpectralSignature(i, machineSpectra[i]);
+    }
+}
+
+// Spherical k-means over the stored signatures
+void BuildSpectralLists(int lists, int iterations) {
+    int stored = (int)std::min<uint64_t>(spectralInserted, spectralCapacity);
+    lists = std::max(1, std::min(lists, stored));
+    spectralCentroids.assign(lists, SpectralSignature{});
+    for (int c = 0; c < lists; c++) {
+        spectralCentroids[c] = spectralSignatures[(size_t)c * stored / lists];
+    }
+
+    std::vector<int> assignment(stored, 0);
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (int slot = 0; slot < stored; slot++) {
+            assignment[slot] = NearestSpectralCentroid(spectralSignatures[slot]);
+        }
+        std::vector<SpectralSignature> sums(lists, SpectralSignature{});
+        for (int slot = 0; slot < stored; slot++) {
+            for (int k = 0; k < SPECTRAL_BANDS; k++) sums[assignment[slot]].bands[k] += spectralSignatures[slot].bands[k];
+        }
+        for (int c = 0; c < lists; c++) {
+            NormalizeSignature(sums[c]);
+            // Keep the old centroid for lists that went empty
+            if (SpectralDot(sums[c], sums[c]) > 0.0f) spectralCentroids[c] = sums[c];
+        }
+    }
+
+    spectralLists.assign(lists, {});
+    std::fill(spectralSlotList.begin(), spectralSlotList.end(), -1);
+    for (int slot = 0; slot < stored; slot++) {
+        ListSpectralSlot(slot, NearestSpectralCentroid(spectralSignatures[slot]));
+    }
+}
+
+// Keep the k best (slot, similarity) pairs in descending order
+void OfferSpectralMatch(int slot, float similarity, int k, std::vector<std::pair<float, int>>& best) {
+    if ((int)best.size() == k && similarity <= best.back().first) return;
+    if ((int)best.size() < k) best.push_back({ similarity, slot });
+    else best.back() = { similarity, slot };
+    for (int p = (int)best.size() - 1; p > 0 && best[p].first > best[p - 1].first; p--) {
+        std::swap(best[p], best[p - 1]);
+    }
+}
+
+// excludeMachine/excludeTime skip the query's own entry (machine -1 to disable)
+int SearchSpectralSignatures(const SpectralSignature& query, int k, int nprobe, int excludeMachine, double excludeTime,
+                             std::vector<std::pair<float, int>>& best) {
+    best.clear();
+    int stored = (int)std::min<uint64_t>(spectralInserted, spectralCapacity);
+    auto skip = [&](int slot) {
+        return spectralEntries[slot].machine == excludeMachine && spectralEntries[slot].time == excludeTime;
+    };
+
+    if (nprobe <= 0 || spectralCentroids.empty()) {
+        for (int slot = 0; slot < stored; slot++) {
+            float similarity = SpectralDot(query, spectralSignatures[slot]);
+            if (!skip(slot)) OfferSpectralMatch(slot, similarity, k, best);
+        }
+        return (int)best.size();
+    }
+
+    std::vector<std::pair<float, int>> probes;
+    for (int c = 0; c < (int)spectralCentroids.size(); c++) {
+        OfferSpectralMatch(c, SpectralDot(query, spectralCentroids[c]), nprobe, probes);
+    }
+    for (const auto& probe : probes) {
+        for (int slot : spectralLists[probe.second]) {
+            if (skip(slot)) continue;
+            OfferSpectralMatch(slot, SpectralDot(query, spectralSignatures[slot]), k, best);
+        }
+    }
+    return (int)best.size();
+}
+
+int CopySpectralMatches(const std::vector<std::pair<float, int>>& best, int* machines, double* times, double* similarities) {
+    for (int r = 0; r < (int)best.size(); r++) {
+        const SpectralEntry& entry = spectralEntries[best[r].second];
+        if (machines != nullptr) machines[r] = entry.machine;
+        if (times != nullptr) times[r] = entry.time;
+        if (similarities != nullptr) similarities[r] = best[r].first;
+    }
+    return (int)best.size();
+}
+
+// ========================================================================
+// ACOUSTIC SYNTHESIS AND FILTER BANK
+// ========================================================================
+// Each step synthesizes a block of sound pressure per running machine with
+// acoustic analysis enabled (EnableAcousticAnalysis, off by default) at
+// ACOUSTIC_SAMPLE_RATE (electrical hum, fan blade-pass and rotor slot
+// tones, broadband flow noise and bearing noise growing with wear), scaled
+// so its unweighted level matches the physics soundLevel. A streaming
+// analyzer keeps filter state across blocks and reports per block:
+//   - A-weighted level (LAeq): three bilinear-transformed biquads
+//   - 1/1 or 1/3-octave band levels: each band is a 4th-order Butterworth
+//     band-pass (two sections, Geffe pole placement)
+// All filters are transposed direct form II. Band sections sit in
+// ACOUSTIC_LANES fixed lanes (unused lanes have zero coefficients) so the
+// per-sample band loop vectorizes across bands.
+
+const double ACOUSTIC_SAMPLE_RATE = 48000.0;   // Hz
+const int DEFAULT_ACOUSTIC_BLOCK = 4096;       // Samples analyzed per step (~85 ms)
+const int ACOUSTIC_LANES = 32;                 // Band lanes (27 third-octave bands fit)
+const int ACOUSTIC_A_SECTIONS = 3;
+const double ACOUSTIC_REFERENCE_PRESSURE = 20e-6;  // Pa
+const double ACOUSTIC_LINE_FREQUENCY = 50.0;   // Hz - Hum at twice line frequency
+const int ACOUSTIC_FAN_BLADES = 9;
+const int ACOUSTIC_ROTOR_SLOTS = 28;
+
+struct Biquad {
+    double b0, b1, b2, a1, a2;
+};
+
+struct AcousticChannel {
+    // Band-pass sections: lane b of stage s has state z1[s][b], z2[s][b]
+    double z1[2][ACOUSTIC_LANES], z2[2][ACOUSTIC_LANES];
+    double aZ1[ACOUSTIC_A_SECTIONS], aZ2[ACOUSTIC_A_SECTIONS];
+    double toneRe[3], toneIm[3];  // Hum, fan, slot phasors
+    double flowState;             // One-pole low-pass of broadband noise
+    float bandLevel[ACOUSTIC_LANES];
+    float weightedLevel, unweightedLevel;
+};
+
+static int acousticBlock = DEFAULT_ACOUSTIC_BLOCK;
+static bool acousticThirdOctave = true;
+static int acousticBands = 0;
+static double acousticCenters[ACOUSTIC_LANES];
+static double bandB0[2][ACOUSTIC_LANES], bandB1[2][ACOUSTIC_LANES], bandB2[2][ACOUSTIC_LANES];
+static double bandA1[2][ACOUSTIC_LANES], bandA2[2][ACOUSTIC_LANES];
+static Biquad aWeighting[ACOUSTIC_A_SECTIONS];
+static std::vector<int> acousticSlot;           // [machine] -> channel slot, -1 when off
+static std::vector<int> acousticMachines;       // [slot] -> machine
+static std::vector<AcousticChannel> acousticChannels;  // [slot]
+static std::vector<float> acousticBuffer;       // Scratch block
+
+std::complex<double> BiquadResponse(const Biquad& q, double frequency) {
+    std::complex<double> z1 = std::polar(1.0, -VIB_TWO_PI * frequency / ACOUSTIC_SAMPLE_RATE);
+    std::complex<double> z2 = z1 * z1;
+    return (q.b0 + q.b1 * z1 + q.b2 * z2) / (1.0 + q.a1 * z1 + q.a2 * z2);
+}
+
+// Bilinear transform of (B0 s^2 + B1 s + B2) / (A0 s^2 + A1 s + A2)
+Biquad BilinearBiquad(double B0, double B1, double B2, double A0, double A1, double A2) {
+    double k = 2.0 * ACOUSTIC_SAMPLE_RATE, k2 = k * k;
+    double a0 = A0 * k2 + A1 * k + A2;
+    return Biquad{ (B0 * k2 + B1 * k + B2) / a0, 2.0 * (B2 - B0 * k2) / a0, (B0 * k2 - B1 * k + B2) / a0,
+                   2.0 * (A2 - A0 * k2) / a0, (A0 * k2 - A1 * k + A2) / a0 };
+}
+
+// Constant 0 dB peak band-pass section
+Biquad BandPassBiquad(double center, double q) {
+    double w0 = VIB_TWO_PI * center / ACOUSTIC_SAMPLE_RATE;
+    double alpha = std::sin(w0) / (2.0 * q);
+    double a0 = 1.0 + alpha;
+    return Biquad{ alpha / a0, 0.0, -alpha / a0, -2.0 * std::cos(w0) / a0, (1.0 - alpha) / a0 };
+}
+
+void DesignAcousticFilters() {
+    // IEC 61672 A-weighting poles (Hz), normalized to 0 dB at 1 kHz
+    // The 12.2 kHz pole is prewarped to offset bilinear compression near Nyquist
+    double w1 = VIB_TWO_PI * 20.598997, w2 = VIB_TWO_PI * 107.65265;
+    double w3 = VIB_TWO_PI * 737.86223;
+    double w4 = 2.0 * ACOUSTIC_SAMPLE_RATE * std::tan(VIB_TWO_PI * 12194.217 / (2.0 * ACOUSTIC_SAMPLE_RATE));
+    aWeighting[0] = BilinearBiquad(1.0, 0.0, 0.0, 1.0, 2.0 * w1, w1 * w1);
+    aWeighting[1] = BilinearBiquad(1.0, 0.0, 0.0, 1.0, w2 + w3, w2 * w3);
+    aWeighting[2] = BilinearBiquad(0.0, 0.0, w4 * w4, 1.0, 2.0 * w4, w4 * w4);
+    std::complex<double> gain = 1.0;
+    for (const Biquad& q : aWeighting) gain *= BiquadResponse(q, 1000.0);
+    double scale = 1.0 / std::abs(gain);
+    aWeighting[2].b0 *= scale;
+    aWeighting[2].b1 *= scale;
+    aWeighting[2].b2 *= scale;
+
+    // Base-10 band centres: 1/3-octave 25 Hz - 10 kHz, octave 31.5 Hz - 8 kHz
+    int fraction = acousticThirdOctave ? 3 : 1;
+    int first = acousticThirdOctave ? -16 : -5, last = acousticThirdOctave ? 10 : 3;
+    acousticBands = last - first + 1;
+    double octave = std::pow(10.0, 0.3);
+    for (int s = 0; s < 2; s++) {
+        for (int b = 0; b < ACOUSTIC_LANES; b++) {
+            bandB0[s][b] = bandB1[s][b] = bandB2[s][b] = bandA1[s][b] = bandA2[s][b] = 0.0;
+        }
+    }
+    for (int b = 0; b < acousticBands; b++) {
+        double center = 1000.0 * std::pow(10.0, (first + b) * 3.0 / (10.0 * fraction));
+        double bandwidth = center * (std::pow(octave, 0.5 / fraction) - std::pow(octave, -0.5 / fraction));
+        double bandQ = center / bandwidth;
+        acousticCenters[b] = center;
+
+        // Geffe: split the 2nd-order Butterworth prototype pole pair into two sections
+        double alpha = std::sqrt(0.5), beta = std::sqrt(0.5);
+        double c = alpha * alpha + beta * beta;
+        double d = 2.0 * alpha / bandQ;
+        double e = c / (bandQ * bandQ) + 4.0;
+        double g = std::sqrt(e * e - 4.0 * d * d);
+        double sectionQ = std::sqrt((e + g) / 2.0) / d;
+        double m = alpha * sectionQ / bandQ;
+        double w = m + std::sqrt(m * m - 1.0);
+        Biquad sections[2] = { BandPassBiquad(center / w, sectionQ), BandPassBiquad(center * w, sectionQ) };
+        double scale = 1.0 / std::abs(BiquadResponse(sections[0], center) * BiquadResponse(sections[1], center));
+        for (int s = 0; s < 2; s++) {
+            double gain = s == 0 ? scale : 1.0;
+            bandB0[s][b] = sections[s].b0 * gain;
+            bandB1[s][b] = sections[s].b1 * gain;
+            bandB2[s][b] = sections[s].b2 * gain;
+            bandA1[s][b] = sections[s].a1;
+            bandA2[s][b] = sections[s].a2;
+        }
+    }
+}
+
+void ResetAcousticChannel(AcousticChannel& channel) {
+    channel = AcousticChannel{};
+    for (int t = 0; t < 3; t++) channel.toneRe[t] = 1.0;
+}
+
+// Streaming analysis of one block; levels are Leq over the block in dB SPL
+void AnalyzeAcousticBlock(AcousticChannel& channel, const float* samples, int count) {
+    double bandEnergy[ACOUSTIC_LANES] = {};
+    double weightedEnergy = 0.0, energy = 0.0;
+    for (int n = 0; n < count; n++) {
+        double x = samples[n];
+        energy += x * x;
+
+        double y = x;
+        for (int s = 0; s < ACOUSTIC_A_SECTIONS; s++) {
+            const Biquad& q = aWeighting[s];
+            double out = q.b0 * y + channel.aZ1[s];
+            channel.aZ1[s] = q.b1 * y - q.a1 * out + channel.aZ2[s];
+            channel.aZ2[s] = q.b2 * y - q.a2 * out;
+            y = out;
+        }
+        weightedEnergy += y * y;
+
+        // Both band-pass stages for every band lane
+        double stage[ACOUSTIC_LANES];
+        for (int b = 0; b < ACOUSTIC_LANES; b++) {
+            double out = bandB0[0][b] * x + channel.z1[0][b];
+            channel.z1[0][b] = bandB1[0][b] * x - bandA1[0][b] * out + channel.z2[0][b];
+            channel.z2[0][b] = bandB2[0][b] * x - bandA2[0][b] * out;
+            stage[b] = out;
+        }
+        for (int b = 0; b < ACOUSTIC_LANES; b++) {
+            double in = stage[b];
+            double out = bandB0[1][b] * in + channel.z1[1][b];
+            channel.z1[1][b] = bandB1[1][b] * in - bandA1[1][b] * out + channel.z2[1][b];
+            channel.z2[1][b] = bandB2[1][b] * in - bandA2[1][b] * out;
+            bandEnergy[b] += out * out;
+        }
+    }
+
+    double reference = ACOUSTIC_REFERENCE_PRESSURE * ACOUSTIC_REFERENCE_PRESSURE * std::max(1, count);
+    auto level = [&](double e) { return (float)(10.0 * std::log10(std::max(e / reference, 1.0))); };
+    channel.unweightedLevel = level(energy);
+    channel.weightedLevel = level(weightedEnergy);
+    for (int b = 0; b < ACOUSTIC_LANES; b++) channel.bandLevel[b] = b < acousticBands ? level(bandEnergy[b]) : 0.0f;
+}
+
+void SynthesizeAcousticBlock(const MotorState& state, AcousticChannel& channel, float* out, int count) {
+    double shaftHz = state.speed / 60.0;
+    const double frequency[3] = { 2.0 * ACOUSTIC_LINE_FREQUENCY, shaftHz * ACOUSTIC_FAN_BLADES, shaftHz * ACOUSTIC_ROTOR_SLOTS };
+    const double amplitude[3] = { 0.3 + 0.4 * state.load, 0.6, 0.4 };
+    double rotateCos[3], rotateSin[3];
+    for (int t = 0; t < 3; t++) {
+        rotateCos[t] = std::cos(VIB_TWO_PI * frequency[t] / ACOUSTIC_SAMPLE_RATE);
+        rotateSin[t] = std::sin(VIB_TWO_PI * frequency[t] / ACOUSTIC_SAMPLE_RATE);
+        // Renormalize once per block against phasor drift
+        double norm = std::sqrt(channel.toneRe[t] * channel.toneRe[t] + channel.toneIm[t] * channel.toneIm[t]);
+        channel.toneRe[t] /= norm;
+        channel.toneIm[t] /= norm;
+    }
+    double flowPole = std::exp(-VIB_TWO_PI * 800.0 / ACOUSTIC_SAMPLE_RATE);
+    double bearingLevel = 0.05 + 0.8 * state.bearingWear;
+
+    double sumSquares = 0.0;
+    for (int n = 0; n < count; n++) {
+        double value = 0.0;
+        for (int t = 0; t < 3; t++) {
+            value += amplitude[t] * channel.toneIm[t];
+            double re = channel.toneRe[t] * rotateCos[t] - channel.toneIm[t] * rotateSin[t];
+            channel.toneIm[t] = channel.toneRe[t] * rotateSin[t] + channel.toneIm[t] * rotateCos[t];
+            channel.toneRe[t] = re;
+        }
+        // Shares the cheap Gaussian source used for vibration windows
+        channel.flowState = flowPole * channel.flowState + (1.0 - flowPole) * 4.0 * VibrationNoise();
+        value += channel.flowState + bearingLevel * VibrationNoise();
+        out[n] = (float)value;
+        sumSquares += value * value;
+    }
+
+    // Scale so the unweighted block level equals soundLevel (dB SPL)
+    double targetRms = ACOUSTIC_REFERENCE_PRESSURE * std::pow(10.0, state.soundLevel / 20.0);
+    double rms = std::sqrt(sumSquares / std::max(1, count));
+    float scale = rms > 0.0 ? (float)(targetRms / rms) : 0.0f;
+    for (int n = 0; n < count; n++) out[n] *= scale;
+}
+
+// Redesign the filters for the band mode and restart every channel
+void ResetAcousticChannels() {
+    DesignAcousticFilters();
+    for (AcousticChannel& channel : acousticChannels) ResetAcousticChannel(channel);
+    acousticBuffer.assign(acousticBlock, 0.0f);
+}
+
+void ResizeAcousticChannels(int count) {
+    acousticSlot.assign(count, -1);
+    acousticMachines.clear();
+    acousticChannels.clear();
+    ResetAcousticChannels();
+}
+
+// Add or remove a machine from the analyzed set; the last slot fills a gap
+void SetAcousticAnalysis(int index, bool enabled) {
+    int slot = acousticSlot[index];
+    if (enabled == (slot >= 0)) return;
+    if (enabled) {
+        acousticSlot[index] = (int)acousticMachines.size();
+        acousticMachines.push_back(index);
+        acousticChannels.emplace_back();
+        ResetAcousticChannel(acousticChannels.back());
+    } else {
+        int moved = acousticMachines.back();
+        acousticMachines[slot] = moved;
+        acousticChannels[slot] = acousticChannels.back();
+        acousticSlot[moved] = slot;
+        acousticMachines.pop_back();
+        acousticChannels.pop_back();
+        acousticSlot[index] = -1;
+    }
+}
+
+void UpdateAcousticChannels() {
+    if (acousticBlock <= 0) return;
+    for (int slot = 0; slot < (int)acousticMachines.size(); slot++) {
+        int i = acousticMachines[slot];
+        AcousticChannel& channel = acousticChannels[slot];
+        if (!fleet[i].isRunning) {
+            std::fill(acousticBuffer.begin(), acousticBuffer.end(), 0.0f);
+        } else {
+            SynthesizeAcousticBlock(fleet[i], channel, acousticBuffer.data(), acousticBlock);
+        }
+        AnalyzeAcousticBlock(channel, acousticBuffer.data(), acousticBlock);
+    }
+}
+
+// ========================================================================
+// LUMPED THERMAL NETWORK (winding, core, rotor, bearings, housing)
+// ========================================================================
+// Six-node conduction/convection network per motor, driven by loss
+// components split from the engine's total loss:
+//   copper  ~ current^2        -> winding (stator) and rotor (cage)
+//   iron    ~ (speed ratio)^1.5 -> stator core
+//   friction ~ speed * wear/oil -> bearings; windage ~ speed^3 -> rotor
+// Backward Euler gives (C/dt + G) T' = C/dt T + P + G_amb T_amb. The
+// matrix is shared by the whole fleet, so it is Cholesky-factorized once
+// per parameter set and step size; each step is a batched triangular solve
+// over SoA temperatures with the machine as the inner loop. The shaft-fan
+// share of housing cooling varies with speed and is applied explicitly so
+// the factorized matrix stays fixed.
+
+const int TN_WINDING = 0;
+const int TN_STATOR_CORE = 1;
+const int TN_ROTOR = 2;
+const int TN_BEARING_DE = 3;
+const int TN_BEARING_NDE = 4;
+const int TN_HOUSING = 5;
+const int TN_NODES = 6;
+
+const double TN_DEFAULT_CAPACITY[TN_NODES] = { 3000.0, 15000.0, 8000.0, 800.0, 800.0, 25000.0 };  // J/K
+const double TN_AMBIENT_CONDUCTANCE = 25.0;     // W/K - Housing natural convection
+const double TN_FAN_CONDUCTANCE = 32.0;         // W/K - Extra housing cooling at rated speed
+const double TN_PHASE_RESISTANCE = 0.15;        // Ohm
+const double TN_RATED_IRON_LOSS = 400.0;        // W
+const double TN_RATED_FRICTION_LOSS = 60.0;     // W
+const double TN_RATED_WINDAGE_LOSS = 100.0;     // W
+
+struct ThermalNetwork {
+    double capacity[TN_NODES];
+    double conductance[TN_NODES][TN_NODES];   // Symmetric node-to-node W/K
+    double ambientConductance[TN_NODES];
+    double factor[TN_NODES][TN_NODES];        // Cholesky factor (lower)
+    double factoredDt;                        // 0 when the factor is stale
+};
+
+static ThermalNetwork thermalNetwork;
+static std::vector<double> tnTemperature[TN_NODES];  // SoA: tnTemperature[node][machine]
+static std::vector<double> tnRhs[TN_NODES];          // Scratch right-hand side
+
+void SetDefaultThermalNetwork() {
+    ThermalNetwork& n = thermalNetwork;
+    for (int a = 0; a < TN_NODES; a++) {
+        n.capacity[a] = TN_DEFAULT_CAPACITY[a];
+        n.ambientConductance[a] = 0.0;
+        for (int b = 0; b < TN_NODES; b++) n.conductance[a][b] = 0.0;
+    }
+    auto link = [&](int a, int b, double g) { n.conductance[a][b] = n.conductance[b][a] = g; };
+    link(TN_WINDING, TN_STATOR_CORE, 60.0);
+    link(TN_STATOR_CORE, TN_HOUSING, 120.0);
+    link(TN_ROTOR, TN_STATOR_CORE, 25.0);     // Across the air gap
+    link(TN_ROTOR, TN_BEARING_DE, 6.0);       // Along the shaft
+    link(TN_ROTOR, TN_BEARING_NDE, 6.0);
+    link(TN_BEARING_DE, TN_HOUSING, 20.0);
+    link(TN_BEARING_NDE, TN_HOUSING, 20.0);
+    n.ambientConductance[TN_HOUSING] = TN_AMBIENT_CONDUCTANCE;
+    n.factoredDt = 0.0;
+}
+
+// Returns false if the system matrix is not positive definite
+bool FactorThermalNetwork(double dtSeconds) {
+    ThermalNetwork& n = thermalNetwork;
+    double a[TN_NODES][TN_NODES];
+    for (int r = 0; r < TN_NODES; r++) {
+        double diagonal = n.capacity[r] / dtSeconds + n.ambientConductance[r];
+        for (int c = 0; c < TN_NODES; c++) {
+            a[r][c] = r == c ? 0.0 : -n.conductance[r][c];
+            if (r != c) diagonal += n.conductance[r][c];
+        }
+        a[r][r] = diagonal;
+    }
+    for (int r = 0; r < TN_NODES; r++) {
+        for (int c = 0; c <= r; c++) {
+            double sum = a[r][c];
+            for (int k = 0; k < c; k++) sum -= n.factor[r][k] * n.factor[c][k];
+            if (r == c) {
+                if (sum <= 0.0) return false;
+                n.factor[r][r] = std::sqrt(sum);
+            } else {
+                n.factor[r][c] = sum / n.factor[c][c];
+            }
+        }
+        for (int c = r + 1; c < TN_NODES; c++) n.factor[r][c] = 0.0;
+    }
+    n.factoredDt = dtSeconds;
+    return true;
+}
+
+// Loss components (W) scaled so their sum equals the engine's total loss
+void ThermalNetworkLosses(const MotorState& state, double* nodePower) {
+    for (int a = 0; a < TN_NODES; a++) nodePower[a] = 0.0;
+    if (!state.isRunning) return;
+    double speedRatio = std::max(0.0, state.speed / BASE_SPEED);
+    double copper = 3.0 * state.current * state.current * TN_PHASE_RESISTANCE;
+    double iron = TN_RATED_IRON_LOSS * std::pow(speedRatio, 1.5);
+    double friction = TN_RATED_FRICTION_LOSS * speedRatio * (1.0 + 3.0 * state.bearingWear) * (1.0 + state.oilDegradation);
+    double windage = TN_RATED_WINDAGE_LOSS * speedRatio * speedRatio * speedRatio;
+    double modelled = copper + iron + friction + windage;
+    double scale = modelled > 0.0 ? MachineLossPower(state) / modelled : 0.0;
+
+    nodePower[TN_WINDING] = 0.7 * copper * scale;
+    nodePower[TN_ROTOR] = (0.3 * copper + windage) * scale;
+    nodePower[TN_STATOR_CORE] = iron * scale;
+    nodePower[TN_BEARING_DE] = 0.55 * friction * scale;   // Drive end carries the belt/coupling load
+    nodePower[TN_BEARING_NDE] = 0.45 * friction * scale;
+}
+
+void ResizeThermalNetwork(int count) {
+    if (thermalNetwork.capacity[0] == 0.0) SetDefaultThermalNetwork();
+    for (int a = 0; a < TN_NODES; a++) {
+        tnTemperature[a].resize(count);
+        tnRhs[a].assign(count, 0.0);
+        for (int i = 0; i < count; i++) tnTemperature[a][i] = fleet[i].ambientTemperature;
+    }
+}
+
+void UpdateThermalNetwork(double dtSeconds) {
+    if (dtSeconds <= 0.0) return;
+    if (thermalNetwork.factoredDt != dtSeconds && !FactorThermalNetwork(dtSeconds)) return;
+    const ThermalNetwork& n = thermalNetwork;
+    int count = (int)fleet.size();
+
+    // Right-hand side: stored heat + losses + ambient exchange (fan share explicit)
+    double power[TN_NODES];
+    for (int i = 0; i < count; i++) {
+        const MotorState& state = fleet[i];
+        ThermalNetworkLosses(state, power);
+        double fan = state.isRunning ? TN_FAN_CONDUCTANCE * std::max(0.0, state.speed / BASE_SPEED) : 0.0;
+        for (int a = 0; a < TN_NODES; a++) {
+            tnRhs[a][i] = n.capacity[a] / dtSeconds * tnTemperature[a][i] + power[a] +
+                          n.ambientConductance[a] * state.ambientTemperature;
+        }
+        tnRhs[TN_HOUSING][i] -= fan * (tnTemperature[TN_HOUSING][i] - state.ambientTemperature);
+    }
+
+    // Forward then backward substitution, machines innermost
+    for (int r = 0; r < TN_NODES; r++) {
+        double* y = tnRhs[r].data();
+        for (int k = 0; k < r; k++) {
+            const double* yk = tnRhs[k].data();
+            double l = n.factor[r][k];
+            for (int i = 0; i < count; i++) y[i] -= l * yk[i];
+        }
+        double inv = 1.0 / n.factor[r][r];
+        for (int i = 0; i < count; i++) y[i] *= inv;
+    }
+    for (int r = TN_NODES - 1; r >= 0; r--) {
+        double* x = tnRhs[r].data();
+        for (int k = r + 1; k < TN_NODES; k++) {
+            const double* xk = tnRhs[k].data();
+            double l = n.factor[k][r];
+            for (int i = 0; i < count; i++) x[i] -= l * xk[i];
+        }
+        double inv = 1.0 / n.factor[r][r];
+        for (int i = 0; i < count; i++) x[i] *= inv;
+    }
+    for (int a = 0; a < TN_NODES; a++) tnTemperature[a].swap(tnRhs[a]);
+}
+
+// ========================================================================
+// HOUSING THERMAL GRID (optional, per machine)
+// ========================================================================
+// 2D finite-difference temperature field of the housing surface for
+// thermography views. The grid is half the circumference (HG_NX, mirror
+// symmetric) by the axial length (HG_NY, y = 0 at the drive end). Heat
+// enters from the thermal network: the core-to-housing flow over the
+// stator stack and the bearing-to-housing flows at each end. Natural
+// convection is uniform; shaft-fan cooling is strongest at the non-drive
+// end and conduction into the mounting feet cools the bottom columns
+// (x near HG_NX); both vary per cell and, as in the network, are applied
+// explicitly.
+//
+// Peaceman-Rachford ADI: each half step is implicit along one axis, with
+// constant-coefficient Thomas factors precomputed per substep size. The
+// grid alternates between [y][x] and transposed [x][y] layouts so that
+// both tridiagonal sweeps run with the independent lines in the
+// contiguous inner loop. One grid (12 KB) stays in L1 for a whole step,
+// and enabled machines are spread across worker threads.
+
+const int HG_NX = 48;                  // Cells around half the circumference
+const int HG_NY = 32;                  // Cells along the axis
+const double HG_WIDTH = 0.47;          // m - Half circumference
+const double HG_LENGTH = 0.40;         // m - Axial length
+const double HG_DIFFUSIVITY = 6.0e-5;  // m^2/s - Cast aluminium
+const double HG_MAX_SUBSTEP = 10.0;    // s
+const double HG_STACK_START = 0.2;     // Stator stack axial extent (fraction of length)
+const double HG_STACK_END = 0.8;
+const int HG_BEARING_ROWS = 3;         // Rows heated by each bearing
+const double HG_FAN_DECAY = 0.35;      // Fan cooling e-folding length (fraction of length)
+const int HG_FOOT_COLUMNS = 8;         // Bottom columns bolted to the base
+const double HG_FOOT_CONDUCTANCE = 5.0;  // W/K - Housing to base through the feet
+
+struct HousingSweep {
+    double substep;
+    double rx, ry, beta;                 // Diffusion numbers and natural convection rate (1/s)
+    double xLower[HG_NX], xInv[HG_NX], xUpper[HG_NX];  // Thomas factors along x
+    double yLower[HG_NY], yInv[HG_NY], yUpper[HG_NY];  // Thomas factors along y
+};
+
+static HousingSweep housingSweep = {};
+static std::vector<std::vector<double>> housingGrids;  // Empty when disabled, else [y][x]
+static double housingFanProfile[HG_NY];                // Sums to 1 across rows
+
+// Thomas factors for a constant tridiagonal system: diag on the diagonal,
+// -r off it, mirror (Neumann) ends where the end line couples with -2r
+void PrepareThomas(int n, double diag, double r, double* lower, double* inv, double* upper) {
+    for (int i = 0; i < n; i++) {
+        lower[i] = i == 0 ? 0.0 : (i == n - 1 ? -2.0 * r : -r);
+        double c = i == 0 ? -2.0 * r : (i == n - 1 ? 0.0 : -r);
+        inv[i] = 1.0 / (diag - (i == 0 ? 0.0 : lower[i] * upper[i - 1]));
+        upper[i] = c * inv[i];  // Modified upper coefficient c'
+    }
+}
+
+void PrepareHousingSweep(double substep) {
+    HousingSweep& h = housingSweep;
+    double lambda = substep / 2.0;
+    double dx = HG_WIDTH / HG_NX, dy = HG_LENGTH / HG_NY;
+    h.substep = substep;
+    h.rx = lambda * HG_DIFFUSIVITY / (dx * dx);
+    h.ry = lambda * HG_DIFFUSIVITY / (dy * dy);
+    h.beta = TN_AMBIENT_CONDUCTANCE / thermalNetwork.capacity[TN_HOUSING];
+    PrepareThomas(HG_NX, 1.0 + lambda * h.beta / 2.0 + 2.0 * h.rx, h.rx, h.xLower, h.xInv, h.xUpper);
+    PrepareThomas(HG_NY, 1.0 + lambda * h.beta / 2.0 + 2.0 * h.ry, h.ry, h.yLower, h.yInv, h.yUpper);
+
+    double sum = 0.0;
+    for (int y = 0; y < HG_NY; y++) {
+        housingFanProfile[y] = std::exp(-(HG_NY - 1 - y) / (HG_FAN_DECAY * HG_NY));
+        sum += housingFanProfile[y];
+    }
+    for (int y = 0; y < HG_NY; y++) housingFanProfile[y] /= sum;
+}
+
+// Solve along the first index of a [n][lines] block in place; every line
+// shares the same factors so the inner loop runs across lines
+void SweepThomas(double* data, int n, int lines, const double* lower, const double* inv, const double* upper) {
+    for (int l = 0; l < lines; l++) data[l] *= inv[0];
+    for (int i = 1; i < n; i++) {
+        double* row = data + (size_t)i * lines;
+        const double* previous = row - lines;
+        for (int l = 0; l < lines; l++) row[l] = (row[l] - lower[i] * previous[l]) * inv[i];
+    }
+    for (int i = n - 2; i >= 0; i--) {
+        double* row = data + (size_t)i * lines;
+        const double* next = row + lines;
+        for (int l = 0; l < lines; l++) row[l] -= upper[i] * next[l];
+    }
+}
+
+// Advance one grid by dtSeconds; source[y] is W per row, fanRate 1/s of total fan cooling
+void StepHousingGrid(std::vector<double>& grid, const double* rowSource, double fanRate, double ambient, double dtSeconds) {
+    const HousingSweep& h = housingSweep;
+    double lambda = h.substep / 2.0;
+    double cellCapacity = thermalNetwork.capacity[TN_HOUSING] / (HG_NX * HG_NY);
+    double a = 1.0 - lambda * h.beta / 2.0;
+    double forcing[HG_NY], fan[HG_NY], foot[HG_NX];
+    alignas(64) double transposed[HG_NX * HG_NY];
+    alignas(64) double work[HG_NX * HG_NY];
+
+    for (int x = 0; x < HG_NX; x++) {
+        foot[x] = x >= HG_NX - HG_FOOT_COLUMNS
+            ? lambda * HG_FOOT_CONDUCTANCE / (HG_FOOT_COLUMNS * HG_NY * cellCapacity) : 0.0;
+    }
+
+    int substeps = std::max(1, (int)std::lround(dtSeconds / h.substep));
+    for (int s = 0; s < substeps; s++) {
+        for (int y = 0; y < HG_NY; y++) {
+            fan[y] = fanRate * housingFanProfile[y] * HG_NY;
+            forcing[y] = lambda * (rowSource[y] / (HG_NX * cellCapacity) + h.beta * ambient);
+        }
+
+        // Half step 1: explicit along y (rows contiguous in x), implicit along x
+        for (int y = 0; y < HG_NY; y++) {
+            const double* row = &grid[(size_t)y * HG_NX];
+            const double* up = &grid[(size_t)(y == 0 ? 1 : y - 1) * HG_NX];
+            const double* down = &grid[(size_t)(y == HG_NY - 1 ? HG_NY - 2 : y + 1) * HG_NX];
+            double* out = &work[(size_t)y * HG_NX];
+            double cool = lambda * fan[y];
+            for (int x = 0; x < HG_NX; x++) {
+                out[x] = a * row[x] + h.ry * (up[x] + down[x] - 2.0 * row[x]) + forcing[y] - (cool + foot[x]) * (row[x] - ambient);
+            }
+        }
+        for (int y = 0; y < HG_NY; y++) {
+            for (int x = 0; x < HG_NX; x++) transposed[x * HG_NY + y] = work[y * HG_NX + x];
+        }
+        SweepThomas(transposed, HG_NX, HG_NY, h.xLower, h.xInv, h.xUpper);
+
+        // Half step 2: explicit along x (columns contiguous in y), implicit along y
+        for (int x = 0; x < HG_NX; x++) {
+            const double* column = &transposed[x * HG_NY];
+            const double* left = &transposed[(x == 0 ? 1 : x - 1) * HG_NY];
+            const double* right = &transposed[(x == HG_NX - 1 ? HG_NX - 2 : x + 1) * HG_NY];
+            double* out = &work[x * HG_NY];
+            for (int y = 0; y < HG_NY; y++) {
+                double cool = lambda * fan[y];
+                out[y] = a * column[y] + h.rx * (left[y] + right[y] - 2.0 * column[y]) + forcing[y] - (cool + foot[x]) * (column[y] - ambient);
+            }
+        }
+        for (int x = 0; x < HG_NX; x++) {
+            for (int y = 0; y < HG_NY; y++) grid[(size_t)y * HG_NX + x] = work[x * HG_NY + y];
+        }
+        SweepThomas(grid.data(), HG_NY, HG_NX, h.yLower, h.yInv, h.yUpper);
+    }
+}
+
+// Heat flowing into the housing per axial row (W), from the thermal network
+void HousingRowSources(int index, double* rowSource) {
+    const ThermalNetwork& n = thermalNetwork;
+    double housing = tnTemperature[TN_HOUSING][index];
+    double core = n.conductance[TN_STATOR_CORE][TN_HOUSING] * (tnTemperature[TN_STATOR_CORE][index] - housing);
+    double driveEnd = n.conductance[TN_BEARING_DE][TN_HOUSING] * (tnTemperature[TN_BEARING_DE][index] - housing);
+    double fanEnd = n.conductance[TN_BEARING_NDE][TN_HOUSING] * (tnTemperature[TN_BEARING_NDE][index] - housing);
+
+    int stackFirst = (int)(HG_STACK_START * HG_NY), stackLast = (int)(HG_STACK_END * HG_NY);
+    for (int y = 0; y < HG_NY; y++) {
+        rowSource[y] = 0.0;
+        if (y >= stackFirst && y < stackLast) rowSource[y] += core / (stackLast - stackFirst);
+        if (y < HG_BEARING_ROWS) rowSource[y] += driveEnd / HG_BEARING_ROWS;
+        if (y >= HG_NY - HG_BEARING_ROWS) rowSource[y] += fanEnd / HG_BEARING_ROWS;
+    }
+}
+
+void ResizeHousingGrids(int count) {
+    housingGrids.assign(count, std::vector<double>());
+}
+
+void UpdateHousingGrids(double dtSeconds) {
+    if (dtSeconds <= 0.0) return;
+    std::vector<int> enabled;
+    for (int i = 0; i < (int)housingGrids.size(); i++) {
+        if (!housingGrids[i].empty()) enabled.push_back(i);
+    }
+    if (enabled.empty()) return;
+
+    double substep = dtSeconds / std::ceil(dtSeconds / HG_MAX_SUBSTEP);
+    if (housingSweep.substep != substep) PrepareHousingSweep(substep);
+
+    auto work = [&](int first, int stride) {
+        double rowSource[HG_NY];
+        for (int k = first; k < (int)enabled.size(); k += stride) {
+            int i = enabled[k];
+            const MotorState& state = fleet[i];
+            HousingRowSources(i, rowSource);
+            double fanRate = state.isRunning
+                ? TN_FAN_CONDUCTANCE * std::max(0.0, state.speed / BASE_SPEED) / thermalNetwork.capacity[TN_HOUSING] : 0.0;
+            StepHousingGrid(housingGrids[i], rowSource, fanRate, state.ambientTemperature, dtSeconds);
+        }
+    };
+    int workers = (int)std::max(1u, std::thread::hardware_concurrency());
+    workers = std::max(1, std::min(workers, (int)enabled.size() / 4));
+    std::vector<std::thread> threads;
+    for (int w = 1; w < workers; w++) threads.emplace_back(work, w, workers);
+    work(0, workers);
+    for (std::thread& thread : threads) thread.join();
+}
+
+// ========================================================================
+// ROTOR DYNAMICS (Jeffcott rotor on flexible bearings)
+// ========================================================================
+// Five degrees of freedom per motor: rotor disk (x, y), bearing journal
+// (x, y) and axial (z). The disk hangs on the shaft stiffness ks between
+// disk and journal; the journal sits on the bearing stiffness kb and
+// damping cb, which soften with bearing wear and oil degradation.
+// Forcing: imbalance m*e*w^2 at 1x on the disk, misalignment at 2x on the
+// journal and at 1x axially. Each fleet step integrates a window of
+// ROTOR_WINDOW samples at ROTOR_SAMPLE_RATE (semi-implicit Euler), carrying
+// state across steps. Blocks of ROTOR_LANES machines run with the machine as
+// the inner loop, and shaft angles advance by phasor rotation, so the kernel
+// vectorizes.
+//
+// The window is a steady-state snapshot of the machine's current operating
+// point, not an integration of the fleet step: it covers 0.2 s whatever
+// dtSeconds is, so rotor time does not track the simulated clock that the
+// thermal and OEE integrators follow. Only machines with rotor dynamics
+// enabled (EnableRotorDynamics, off by default) are integrated and hold
+// orbit storage; the rest keep their statistical vibration channels.
+//
+// Outputs per window: journal X/Y and axial velocity RMS (mm/s), shaft
+// displacement peak-to-peak (mm), shaft angle, and the disk orbit. When
+// sensor driving is on (default), they replace the fleet machines'
+// vibration, displacement and shaftPosition channels before the other
+// subsystems read them.
+
+const double ROTOR_SAMPLE_RATE = 10000.0;  // Hz
+const int ROTOR_WINDOW = 2000;             // Samples per fleet step (0.2 s)
+const int ROTOR_ORBIT_SAMPLES = 1024;      // Disk positions kept for orbit queries (<= ROTOR_WINDOW)
+const int ROTOR_LANES = 8;                 // Machines integrated together
+const double ROTOR_DISK_MASS = 20.0;       // kg
+const double ROTOR_JOURNAL_MASS = 8.0;     // kg
+const double ROTOR_AXIAL_MASS = 28.0;      // kg
+const double ROTOR_SHAFT_STIFFNESS = 2.0e7;    // N/m
+const double ROTOR_SHAFT_DAMPING = 200.0;      // N*s/m
+const double ROTOR_BEARING_STIFFNESS = 3.0e7;  // N/m - New bearing
+const double ROTOR_BEARING_DAMPING = 2500.0;   // N*s/m - Fresh oil
+const double ROTOR_AXIAL_STIFFNESS = 5.0e7;    // N/m
+const double ROTOR_AXIAL_DAMPING = 3000.0;     // N*s/m
+const double ROTOR_BASE_ECCENTRICITY = 60e-6;  // m - Residual imbalance
+const double ROTOR_MISALIGNMENT_STIFFNESS = 1.0e6;  // N/m - Coupling stiffness against offset
+const double ROTOR_DEFAULT_MISALIGNMENT = 50e-6;    // m
+
+const int ROTOR_DISK_X = 0, ROTOR_DISK_Y = 1, ROTOR_JOURNAL_X = 2, ROTOR_JOURNAL_Y = 3, ROTOR_AXIAL = 4;
+const int ROTOR_DOF = 5;
+
+struct RotorBank {
+    std::vector<double> position[ROTOR_DOF], velocity[ROTOR_DOF];  // SoA [dof][machine], m and m/s
+    std::vector<double> angleCos, angleSin;                        // Shaft angle phasor
+    std::vector<double> misalignment;                              // m
+    std::vector<double> velocityRms[3];                            // mm/s: X, Y, Z
+    std::vector<double> displacementPP;                            // mm
+    std::vector<float> orbitX, orbitY;                             // [slot][sample], m, oldest first
+};
+
+static RotorBank rotor;
+static bool rotorDrivesSensors = true;
+static std::vector<int> rotorSlot;      // [machine] -> integrated slot, -1 when off
+static std::vector<int> rotorMachines;  // [slot] -> machine
+
+// Put one machine's rotor back at rest with cleared outputs
+void ResetMachineRotor(int index) {
+    for (int d = 0; d < ROTOR_DOF; d++) {
+        rotor.position[d][index] = 0.0;
+        rotor.velocity[d][index] = 0.0;
+    }
+    rotor.angleCos[index] = 1.0;
+    rotor.angleSin[index] = 0.0;
+    for (int a = 0; a < 3; a++) rotor.velocityRms[a][index] = 0.0;
+    rotor.displacementPP[index] = 0.0;
+}
+
+void ResizeRotorDynamics(int count) {
+    for (int d = 0; d < ROTOR_DOF; d++) {
+        rotor.position[d].assign(count, 0.0);
+        rotor.velocity[d].assign(count, 0.0);
+    }
+    rotor.angleCos.assign(count, 1.0);
+    rotor.angleSin.assign(count, 0.0);
+    rotor.misalignment.assign(count, ROTOR_DEFAULT_MISALIGNMENT);
+    for (int a = 0; a < 3; a++) rotor.velocityRms[a].assign(count, 0.0);
+    rotor.displacementPP.assign(count, 0.0);
+    rotor.orbitX.clear();
+    rotor.orbitY.clear();
+    rotorSlot.assign(count, -1);
+    rotorMachines.clear();
+}
+
+// Add or remove a machine from the integrated set; the last slot (and its
+// orbit) fills a gap, and a removed rotor is put back at rest
+void SetRotorDynamics(int index, bool enabled) {
+    int slot = rotorSlot[index];
+    if (enabled == (slot >= 0)) return;
+    if (enabled) {
+        rotorSlot[index] = (int)rotorMachines.size();
+        rotorMachines.push_back(index);
+        rotor.orbitX.resize(rotorMachines.size() * ROTOR_ORBIT_SAMPLES, 0.0f);
+        rotor.orbitY.resize(rotorMachines.size() * ROTOR_ORBIT_SAMPLES, 0.0f);
+    } else {
+        int last = (int)rotorMachines.size() - 1;
+        int moved = rotorMachines[last];
+        rotorMachines[slot] = moved;
+        rotorSlot[moved] = slot;
+        std::copy_n(rotor.orbitX.begin() + (size_t)last * ROTOR_ORBIT_SAMPLES, ROTOR_ORBIT_SAMPLES,
+                    rotor.orbitX.begin() + (size_t)slot * ROTOR_ORBIT_SAMPLES);
+        std::copy_n(rotor.orbitY.begin() + (size_t)last * ROTOR_ORBIT_SAMPLES, ROTOR_ORBIT_SAMPLES,
+                    rotor.orbitY.begin() + (size_t)slot * ROTOR_ORBIT_SAMPLES);
+        rotorMachines.pop_back();
+        rotor.orbitX.resize(rotorMachines.size() * ROTOR_ORBIT_SAMPLES);
+        rotor.orbitY.resize(rotorMachines.size() * ROTOR_ORBIT_SAMPLES);
+        rotorSlot[index] = -1;
+        ResetMachineRotor(index);
+    }
+}
+
+void UpdateRotorDynamics() {
+    int active = (int)rotorMachines.size();
+    if (active == 0) return;
+    const double dt = 1.0 / ROTOR_SAMPLE_RATE;
+    const double ks = ROTOR_SHAFT_STIFFNESS, cs = ROTOR_SHAFT_DAMPING;
+    const double invDisk = 1.0 / ROTOR_DISK_MASS, invJournal = 1.0 / ROTOR_JOURNAL_MASS, invAxial = 1.0 / ROTOR_AXIAL_MASS;
+    const int orbitFrom = ROTOR_WINDOW - ROTOR_ORBIT_SAMPLES;
+
+    // Machines advance ROTOR_LANES at a time with the block state in local
+    // arrays for the whole window, so the fixed-width lane loop vectorizes.
+    // Padding lanes carry zero forcing and stay at rest.
+    for (int base = 0; base < active; base += ROTOR_LANES) {
+        int lanes = std::min(ROTOR_LANES, active - base);
+        double xd[ROTOR_LANES] = {}, yd[ROTOR_LANES] = {}, xb[ROTOR_LANES] = {}, yb[ROTOR_LANES] = {}, z[ROTOR_LANES] = {};
+        double vxd[ROTOR_LANES] = {}, vyd[ROTOR_LANES] = {}, vxb[ROTOR_LANES] = {}, vyb[ROTOR_LANES] = {}, vz[ROTOR_LANES] = {};
+        double c[ROTOR_LANES], s[ROTOR_LANES] = {}, rotateCos[ROTOR_LANES], rotateSin[ROTOR_LANES] = {};
+        double imbalance[ROTOR_LANES] = {}, misalignForce[ROTOR_LANES] = {}, bearingK[ROTOR_LANES], bearingC[ROTOR_LANES];
+        double sumX[ROTOR_LANES] = {}, sumY[ROTOR_LANES] = {}, sumZ[ROTOR_LANES] = {};
+        double minX[ROTOR_LANES], maxX[ROTOR_LANES], minY[ROTOR_LANES], maxY[ROTOR_LANES];
+        for (int l = 0; l < ROTOR_LANES; l++) {
+            c[l] = 1.0; rotateCos[l] = 1.0;
+            bearingK[l] = ROTOR_BEARING_STIFFNESS; bearingC[l] = ROTOR_BEARING_DAMPING;
+            minX[l] = minY[l] = INFINITY;
+            maxX[l] = maxY[l] = -INFINITY;
+        }
+        for (int l = 0; l < lanes; l++) {
+            int i = rotorMachines[base + l];
+            const MotorState& state = fleet[i];
+            xd[l] = rotor.position[ROTOR_DISK_X][i]; vxd[l] = rotor.velocity[ROTOR_DISK_X][i];
+            yd[l] = rotor.position[ROTOR_DISK_Y][i]; vyd[l] = rotor.velocity[ROTOR_DISK_Y][i];
+            xb[l] = rotor.position[ROTOR_JOURNAL_X][i]; vxb[l] = rotor.velocity[ROTOR_JOURNAL_X][i];
+            yb[l] = rotor.position[ROTOR_JOURNAL_Y][i]; vyb[l] = rotor.velocity[ROTOR_JOURNAL_Y][i];
+            z[l] = rotor.position[ROTOR_AXIAL][i]; vz[l] = rotor.velocity[ROTOR_AXIAL][i];
+            // Renormalize the phasor once per window against drift
+            double norm = std::hypot(rotor.angleCos[i], rotor.angleSin[i]);
+            c[l] = rotor.angleCos[i] / norm;
+            s[l] = rotor.angleSin[i] / norm;
+
+            double w = state.isRunning ? VIB_TWO_PI * state.speed / 60.0 : 0.0;
+            double eccentricity = ROTOR_BASE_ECCENTRICITY * (1.0 + 2.0 * state.bearingWear);
+            rotateCos[l] = std::cos(w * dt);
+            rotateSin[l] = std::sin(w * dt);
+            imbalance[l] = ROTOR_DISK_MASS * eccentricity * w * w;
+            misalignForce[l] = ROTOR_MISALIGNMENT_STIFFNESS * rotor.misalignment[i] * std::min(1.0, state.speed / BASE_SPEED);
+            bearingK[l] = ROTOR_BEARING_STIFFNESS * (1.0 - 0.6 * std::min(1.0, state.bearingWear));
+            bearingC[l] = ROTOR_BEARING_DAMPING * (1.0 - 0.5 * std::min(1.0, state.oilDegradation));
+        }
+
+        for (int n = 0; n < ROTOR_WINDOW; n++) {
+            for (int l = 0; l < ROTOR_LANES; l++) {
+                double cos2 = c[l] * c[l] - s[l] * s[l], sin2 = 2.0 * c[l] * s[l];
+
+                // Shaft coupling between disk and journal
+                double fx = ks * (xd[l] - xb[l]) + cs * (vxd[l] - vxb[l]);
+                double fy = ks * (yd[l] - yb[l]) + cs * (vyd[l] - vyb[l]);
+                double axd = (imbalance[l] * c[l] - fx) * invDisk;
+                double ayd = (imbalance[l] * s[l] - fy) * invDisk;
+                double axb = (fx - bearingK[l] * xb[l] - bearingC[l] * vxb[l] + misalignForce[l] * cos2) * invJournal;
+                double ayb = (fy - bearingK[l] * yb[l] - bearingC[l] * vyb[l] + misalignForce[l] * sin2) * invJournal;
+                double az = (0.5 * misalignForce[l] * c[l] - ROTOR_AXIAL_STIFFNESS * z[l] - ROTOR_AXIAL_DAMPING * vz[l]) * invAxial;
+
+                // Semi-implicit Euler: velocities first, then positions with the new velocities
+                vxd[l] += axd * dt; vyd[l] += ayd * dt;
+                vxb[l] += axb * dt; vyb[l] += ayb * dt;
+                vz[l] += az * dt;
+                xd[l] += vxd[l] * dt; yd[l] += vyd[l] * dt;
+                xb[l] += vxb[l] * dt; yb[l] += vyb[l] * dt;
+                z[l] += vz[l] * dt;
+
+                sumX[l] += vxb[l] * vxb[l];
+                sumY[l] += vyb[l] * vyb[l];
+                sumZ[l] += vz[l] * vz[l];
+                minX[l] = std::min(minX[l], xd[l]);
+                maxX[l] = std::max(maxX[l], xd[l]);
+                minY[l] = std::min(minY[l], yd[l]);
+                maxY[l] = std::max(maxY[l], yd[l]);
+
+                double rc = c[l] * rotateCos[l] - s[l] * rotateSin[l];
+                s[l] = c[l] * rotateSin[l] + s[l] * rotateCos[l];
+                c[l] = rc;
+            }
+            if (n >= orbitFrom) {
+                size_t sample = (size_t)(base * ROTOR_ORBIT_SAMPLES + n - orbitFrom);
+                for (int l = 0; l < lanes; l++) {
+                    rotor.orbitX[sample + (size_t)l * ROTOR_ORBIT_SAMPLES] = (float)xd[l];
+                    rotor.orbitY[sample + (size_t)l * ROTOR_ORBIT_SAMPLES] = (float)yd[l];
+                }
+            }
+        }
+
+        for (int l = 0; l < lanes; l++) {
+            int i = rotorMachines[base + l];
+            rotor.position[ROTOR_DISK_X][i] = xd[l]; rotor.velocity[ROTOR_DISK_X][i] = vxd[l];
+            rotor.position[ROTOR_DISK_Y][i] = yd[l]; rotor.velocity[ROTOR_DISK_Y][i] = vyd[l];
+            rotor.position[ROTOR_JOURNAL_X][i] = xb[l]; rotor.velocity[ROTOR_JOURNAL_X][i] = vxb[l];
+            rotor.position[ROTOR_JOURNAL_Y][i] = yb[l]; rotor.velocity[ROTOR_JOURNAL_Y][i] = vyb[l];
+            rotor.position[ROTOR_AXIAL][i] = z[l]; rotor.velocity[ROTOR_AXIAL][i] = vz[l];
+            rotor.angleCos[i] = c[l];
+            rotor.angleSin[i] = s[l];
+
+            rotor.velocityRms[0][i] = 1000.0 * std::sqrt(sumX[l] / ROTOR_WINDOW);
+            rotor.velocityRms[1][i] = 1000.0 * std::sqrt(sumY[l] / ROTOR_WINDOW);
+            rotor.velocityRms[2][i] = 1000.0 * std::sqrt(sumZ[l] / ROTOR_WINDOW);
+            rotor.displacementPP[i] = 1000.0 * std::max(maxX[l] - minX[l], maxY[l] - minY[l]);
+
+            if (!rotorDrivesSensors) continue;
+            MotorState& state = fleet[i];
+            state.vibrationX = rotor.velocityRms[0][i];
+            state.vibrationY = rotor.velocityRms[1][i];
+            state.vibrationZ = rotor.velocityRms[2][i];
+            state.vibration = std::sqrt(state.vibrationX * state.vibrationX + state.vibrationY * state.vibrationY +
+                                        state.vibrationZ * state.vibrationZ);
+            state.displacement = rotor.displacementPP[i];
+            double degrees = std::atan2(s[l], c[l]) * 360.0 / VIB_TWO_PI;
+            state.shaftPosition = degrees < 0.0 ? degrees + 360.0 : degrees;
+        }
+    }
+}
+
+// ========================================================================
+// INDUCTION MACHINE ELECTRICAL MODEL (dq frame, V/f drive)
+// ========================================================================
+// Per-machine flux-linkage model in the synchronous frame of the drive
+// output, so the supply voltage is the constant vector (V, 0) and no
+// trigonometry is needed per sample:
+//   dPsiDs = vDs - Rs*iDs + we*PsiQs      dPsiDr = -Rr*iDr + (we - wr)*PsiQr
+//   dPsiQs = vQs - Rs*iQs - we*PsiDs      dPsiQr = -Rr*iQr - (we - wr)*PsiDr
+//   Te = 1.5*p*(PsiDs*iQs - PsiQs*iDs),   J*dwm = Te - TL - B*wm
+// The drive ramps its frequency toward the machine's speed reference (the
+// statistical speed from UpdateMotorPhysics) and applies V/f with a low-end
+// boost; the load torque follows the machine's load factor. Each fleet step
+// integrates ELECTRICAL_WINDOW seconds at the electrical sample rate over
+// blocks of EM_LANES machines, with the machine as the inner loop so the
+// kernel vectorizes across the fleet.
+// Like the rotor window, this is a steady-state snapshot per step: 0.3 s of
+// electrical time pass whatever dtSeconds is, so flux, drive frequency and
+// mechanical speed settle on the current operating point rather than
+// following the simulated clock. Only machines with the model enabled
+// (EnableElectricalModel, off by default) are integrated; the rest keep
+// their statistical electrical channels. Driven machines are flagged for
+// the Kalman estimator, whose fixed current-to-torque line only fits the
+// statistical current.
+// Outputs average over the settled tail of the window and, when sensor
+// driving is on (default), replace speed, torque, voltage, current,
+// powerFactor and powerConsumption on the fleet machines.
+
+const double EM_RATED_POWER = 7500.0;      // W - 2-pole, 230 V, 50 Hz
+const double EM_RATED_VOLTAGE = 230.0;     // V - Line-to-line RMS at rated frequency
+const double EM_RATED_FREQUENCY = 50.0;    // Hz
+const double EM_POLE_PAIRS = 1.0;
+const double EM_STATOR_RESISTANCE = 0.15;  // Ohm
+const double EM_ROTOR_RESISTANCE = 0.12;   // Ohm
+const double EM_LEAKAGE_INDUCTANCE = 1.5e-3;  // H - Stator and rotor each
+const double EM_MAGNETIZING_INDUCTANCE = 0.040;  // H
+const double EM_INERTIA = 0.03;            // kg*m^2 - Motor plus coupled load
+const double EM_FRICTION = 0.002;          // N*m*s/rad
+const double EM_VOLTAGE_BOOST = 0.03;      // Fraction of rated voltage at zero frequency
+const double EM_RATED_TORQUE = EM_RATED_POWER / (VIB_TWO_PI * BASE_SPEED / 60.0);  // N*m at BASE_SPEED
+const double ELECTRICAL_WINDOW = 0.3;      // s simulated per fleet step
+const double ELECTRICAL_AVERAGE_WINDOW = 0.04;  // s - Settled tail used for outputs (2 cycles at 50 Hz)
+const int EM_LANES = 8;                    // Machines integrated together
+
+struct ElectricalBank {
+    std::vector<double> psiDs, psiQs, psiDr, psiQr;  // Wb - Flux linkages
+    std::vector<double> omegaMech;                   // rad/s - Mechanical speed
+    std::vector<double> frequency;                   // Hz - Drive output
+    // Averages over the settled tail of the last window
+    std::vector<double> torque, current, voltage, power, powerFactor, slip, rotorFlux;
+};
+
+static ElectricalBank electrical;
+static double electricalSampleRate = 10000.0;  // Hz
+static double driveRampRate = 200.0;           // Hz/s
+static bool electricalDrivesSensors = true;
+static std::vector<int> electricalSlot;      // [machine] -> integrated slot, -1 when off
+static std::vector<int> electricalMachines;  // [slot] -> machine
+
+void ResizeElectricalModel(int count) {
+    std::vector<double>* all[] = { &electrical.psiDs, &electrical.psiQs, &electrical.psiDr, &electrical.psiQr,
+                                   &electrical.omegaMech, &electrical.frequency, &electrical.torque,
+                                   &electrical.current, &electrical.voltage, &electrical.power,
+                                   &electrical.powerFactor, &electrical.slip, &electrical.rotorFlux };
+    for (std::vector<double>* v : all) v->assign(count, 0.0);
+    electricalSlot.assign(count, -1);
+    electricalMachines.clear();
+}
+
+// De-energize one machine's model: drive at zero frequency, rotor at rest
+void ResetMachineElectrical(int index) {
+    std::vector<double>* all[] = { &electrical.psiDs, &electrical.psiQs, &electrical.psiDr, &electrical.psiQr,
+                                   &electrical.omegaMech, &electrical.frequency, &electrical.torque,
+                                   &electrical.current, &electrical.voltage, &electrical.power,
+                                   &electrical.powerFactor, &electrical.slip, &electrical.rotorFlux };
+    for (std::vector<double>* v : all) (*v)[index] = 0.0;
+    kfCurrentFromModel[index] = 0;
+}
+
+// Add or remove a machine from the integrated set; the last slot fills a gap
+void SetElectricalModel(int index, bool enabled) {
+    int slot = electricalSlot[index];
+    if (enabled == (slot >= 0)) return;
+    if (enabled) {
+        electricalSlot[index] = (int)electricalMachines.size();
+        electricalMachines.push_back(index);
+    } else {
+        int moved = electricalMachines.back();
+        electricalMachines[slot] = moved;
+        electricalSlot[moved] = slot;
+        electricalMachines.pop_back();
+        electricalSlot[index] = -1;
+        ResetMachineElectrical(index);
+    }
+}
+
+void UpdateElectricalModel() {
+    int active = (int)electricalMachines.size();
+    if (active == 0) return;
+    double dt = 1.0 / electricalSampleRate;
+    int samples = (int)(ELECTRICAL_WINDOW * electricalSampleRate);
+    int averageFrom = samples - (int)(ELECTRICAL_AVERAGE_WINDOW * electricalSampleRate);
+    double averageScale = 1.0 / (samples - averageFrom);
+
+    const double ls = EM_MAGNETIZING_INDUCTANCE + EM_LEAKAGE_INDUCTANCE;
+    const double lr = ls, lm = EM_MAGNETIZING_INDUCTANCE;
+    const double invDet = 1.0 / (ls * lr - lm * lm);
+    const double rs = EM_STATOR_RESISTANCE, rr = EM_ROTOR_RESISTANCE, p = EM_POLE_PAIRS;
+    const double ratedPeak = EM_RATED_VOLTAGE * std::sqrt(2.0 / 3.0);  // Phase peak = dq magnitude
+    const double rampStep = driveRampRate * dt;
+
+    // Machines are integrated EM_LANES at a time with the block state held in
+    // local arrays for the whole window: fixed-width lane loops vectorize and
+    // the state stays in L1. Padding lanes idle at zero frequency and load.
+    for (int base = 0; base < active; base += EM_LANES) {
+        int lanes = std::min(EM_LANES, active - base);
+        double psiDs[EM_LANES] = {}, psiQs[EM_LANES] = {}, psiDr[EM_LANES] = {}, psiQr[EM_LANES] = {};
+        double wm[EM_LANES] = {}, freq[EM_LANES] = {}, target[EM_LANES] = {}, loadTorque[EM_LANES] = {};
+        double sumTorque[EM_LANES] = {}, sumCurrentSq[EM_LANES] = {}, sumPower[EM_LANES] = {};
+        double sumVoltage[EM_LANES] = {}, sumSpeed[EM_LANES] = {}, sumFrequency[EM_LANES] = {}, sumFluxSq[EM_LANES] = {};
+        for (int l = 0; l < lanes; l++) {
+            int i = electricalMachines[base + l];
+            const MotorState& state = fleet[i];
+            psiDs[l] = electrical.psiDs[i]; psiQs[l] = electrical.psiQs[i];
+            psiDr[l] = electrical.psiDr[i]; psiQr[l] = electrical.psiQr[i];
+            wm[l] = electrical.omegaMech[i];
+            freq[l] = electrical.frequency[i];
+            // Speed reference is the statistical speed; the drive has no slip compensation
+            target[l] = state.isRunning ? state.speed / 60.0 * EM_POLE_PAIRS : 0.0;
+            loadTorque[l] = state.isRunning ? state.load * EM_RATED_TORQUE : 0.0;
+        }
+
+        for (int n = 0; n < samples; n++) {
+            double weight = n >= averageFrom ? 1.0 : 0.0;
+            for (int l = 0; l < EM_LANES; l++) {
+                // Drive: ramp toward the reference, then V/f with boost (off at zero frequency)
+                double f = freq[l] + std::max(-rampStep, std::min(rampStep, target[l] - freq[l]));
+                freq[l] = f;
+                // One min and one select: further conditionals stop GCC if-converting the lane loop
+                double vDs = std::min(ratedPeak, ratedPeak * (EM_VOLTAGE_BOOST + (1.0 - EM_VOLTAGE_BOOST) * f / EM_RATED_FREQUENCY));
+                vDs = f > 0.0 ? vDs : 0.0;
+                double we = VIB_TWO_PI * f;
+                double slipSpeed = we - p * wm[l];
+
+                double iDs = (lr * psiDs[l] - lm * psiDr[l]) * invDet;
+                double iQs = (lr * psiQs[l] - lm * psiQr[l]) * invDet;
+                double iDr = (ls * psiDr[l] - lm * psiDs[l]) * invDet;
+                double iQr = (ls * psiQr[l] - lm * psiQs[l]) * invDet;
+                double te = 1.5 * p * (psiDs[l] * iQs - psiQs[l] * iDs);
+
+                // Semi-implicit: d axes first, q axes see the updated d fluxes (stable under frame rotation)
+                psiDs[l] += (vDs - rs * iDs + we * psiQs[l]) * dt;
+                psiDr[l] += (-rr * iDr + slipSpeed * psiQr[l]) * dt;
+                psiQs[l] += (-rs * iQs - we * psiDs[l]) * dt;
+                psiQr[l] += (-rr * iQr - slipSpeed * psiDr[l]) * dt;
+                double w = wm[l] + (te - loadTorque[l] - EM_FRICTION * wm[l]) / EM_INERTIA * dt;
+                wm[l] = std::max(0.0, w);
+
+                // Settled-tail averages; squares keep sqrt (and errno) out of the loop
+                sumTorque[l] += weight * te;
+                sumCurrentSq[l] += weight * (iDs * iDs + iQs * iQs);
+                sumPower[l] += weight * 1.5 * vDs * iDs;
+                sumVoltage[l] += weight * vDs;
+                sumSpeed[l] += weight * wm[l];
+                sumFrequency[l] += weight * f;
+                sumFluxSq[l] += weight * (psiDr[l] * psiDr[l] + psiQr[l] * psiQr[l]);
+            }
+        }
+
+        for (int l = 0; l < lanes; l++) {
+            int i = electricalMachines[base + l];
+            electrical.psiDs[i] = psiDs[l]; electrical.psiQs[i] = psiQs[l];
+            electrical.psiDr[i] = psiDr[l]; electrical.psiQr[i] = psiQr[l];
+            electrical.omegaMech[i] = wm[l];
+            electrical.frequency[i] = freq[l];
+
+            double speedRpm = sumSpeed[l] * averageScale * 60.0 / VIB_TWO_PI;
+            double syncRpm = sumFrequency[l] * averageScale * 60.0 / EM_POLE_PAIRS;
+            double currentPeak = std::sqrt(sumCurrentSq[l] * averageScale);
+            double voltagePeak = sumVoltage[l] * averageScale;
+            double apparent = 1.5 * voltagePeak * currentPeak;
+            electrical.torque[i] = sumTorque[l] * averageScale;
+            electrical.current[i] = currentPeak / std::sqrt(2.0);                   // RMS per phase
+            electrical.voltage[i] = voltagePeak * std::sqrt(3.0) / std::sqrt(2.0);  // RMS line-to-line
+            electrical.power[i] = sumPower[l] * averageScale;
+            electrical.powerFactor[i] = apparent > 0.0 ? std::max(0.0, std::min(1.0, electrical.power[i] / apparent)) : 0.0;
+            electrical.slip[i] = syncRpm > 0.0 ? (syncRpm - speedRpm) / syncRpm : 0.0;
+            electrical.rotorFlux[i] = std::sqrt(sumFluxSq[l] * averageScale);
+
+            kfCurrentFromModel[i] = electricalDrivesSensors && fleet[i].isRunning;
+            if (!kfCurrentFromModel[i]) continue;
+            MotorState& state = fleet[i];
+            state.speed = speedRpm;
+            state.rpm = speedRpm;
+            state.torque = electrical.torque[i];
+            state.voltage = electrical.voltage[i];
+            state.current = electrical.current[i];
+            state.powerFactor = electrical.powerFactor[i];
+            state.powerConsumption = electrical.power[i] / 1000.0;
+        }
+    }
+}
+
+// ========================================================================
+// PLANT ELECTRICAL BUS (feeders, transformers, harmonics)
+// ========================================================================
+// Machines hang off feeders, feeders off distribution transformers. Each
+// step every running machine contributes a per-phase current phasor at
+// the fundamental (from its power and power factor) and at the dominant
+// 6-pulse drive harmonics, whose share grows at light load. Phasors are
+// summed per feeder and transformer, so harmonics from machines at
+// different load angles partially cancel as they do on a real bus. From
+// the sums: transformer loading, K-factor, voltage drop (transformer plus
+// feeder cable), voltage THD, and plant displacement/true power factor.
+//
+// The reduction is deterministic: machines are cut into fixed BUS_CHUNK
+// blocks independent of the worker count, each block's partial sums are
+// built in machine order, and blocks are merged in block order. Results are
+// bitwise identical whatever the thread count.
+
+const int BUS_HARMONICS = 5;
+const int BUS_HARMONIC_ORDER[BUS_HARMONICS] = { 1, 5, 7, 11, 13 };
+const double BUS_HARMONIC_FRACTION[BUS_HARMONICS] = { 1.0, 0.30, 0.12, 0.07, 0.05 };  // 6-pulse drive, 3% line reactor
+const double BUS_NOMINAL_VOLTAGE = 400.0;        // V - Line-to-line, transformer secondary
+const double BUS_DEFAULT_RATING = 250.0;         // kVA
+const double BUS_DEFAULT_IMPEDANCE = 5.0;        // % on transformer rating
+const double BUS_TRANSFORMER_XR = 6.0;           // X/R ratio
+const double BUS_FEEDER_RESISTANCE = 0.02;       // Ohm per phase
+const double BUS_FEEDER_REACTANCE = 0.008;       // Ohm per phase at fundamental
+const int BUS_DEFAULT_TRANSFORMERS = 2;
+const int BUS_DEFAULT_FEEDERS_PER_TRANSFORMER = 4;
+const int BUS_CHUNK = 256;                       // Machines per reduction block
+
+struct BusTransformer {
+    double ratingKVA, impedancePercent;
+    std::complex<double> current[BUS_HARMONICS];  // A per phase
+    double currentRms, loadingPercent, kFactor, voltageDropPercent, voltageThdPercent;
+};
+
+struct BusFeeder {
+    int transformer;
+    double resistance, reactance;                 // Ohm per phase
+    std::complex<double> current[BUS_HARMONICS];
+    double currentRms, voltageDropPercent;        // Drop at feeder end, including the transformer
+};
+
+struct PlantBus {
+    double activeKW, reactiveKVAR;
+    double displacementPowerFactor, truePowerFactor, currentThdPercent;
+};
+
+static std::vector<BusTransformer> busTransformers;
+static std::vector<BusFeeder> busFeeders;
+static std::vector<int> machineFeeder;
+static PlantBus plantBus;
+
+void ConfigureBusTopology(int transformers, int feedersPerTransformer) {
+    busTransformers.assign(transformers, BusTransformer());
+    for (BusTransformer& t : busTransformers) {
+        t.ratingKVA = BUS_DEFAULT_RATING;
+        t.impedancePercent = BUS_DEFAULT_IMPEDANCE;
+    }
+    busFeeders.assign(transformers * feedersPerTransformer, BusFeeder());
+    for (int f = 0; f < (int)busFeeders.size(); f++) {
+        busFeeders[f].transformer = f / feedersPerTransformer;
+        busFeeders[f].resistance = BUS_FEEDER_RESISTANCE;
+        busFeeders[f].reactance = BUS_FEEDER_REACTANCE;
+    }
+    // Round-robin spreads machines evenly over feeders
+    for (int i = 0; i < (int)machineFeeder.size(); i++) {
+        machineFeeder[i] = i % (int)busFeeders.size();
+    }
+}
+
+void ResizeElectricalBus(int count) {
+    machineFeeder.assign(count, 0);
+    if (busFeeders.empty()) {
+        ConfigureBusTopology(BUS_DEFAULT_TRANSFORMERS, BUS_DEFAULT_FEEDERS_PER_TRANSFORMER);
+    } else {
+        for (int i = 0; i < count; i++) machineFeeder[i] = i % (int)busFeeders.size();
+    }
+}
+
+// Per-phase fundamental drop across (r + jx) as a percentage of nominal
+// line voltage, projected on the voltage reference
+double BusVoltageDropPercent(std::complex<double> current, double r, double x) {
+    double phaseDrop = (std::complex<double>(r, x) * current).real();
+    return 100.0 * std::sqrt(3.0) * phaseDrop / BUS_NOMINAL_VOLTAGE;
+}
+
+void UpdateElectricalBus() {
+    int count = (int)fleet.size();
+    int feeders = (int)busFeeders.size();
+    if (count == 0 || feeders == 0) return;
+    int chunks = (count + BUS_CHUNK - 1) / BUS_CHUNK;
+    size_t stride = (size_t)feeders * BUS_HARMONICS;
+
+    // partial[chunk][feeder][harmonic]; active/reactive power per chunk
+    std::vector<std::complex<double>> partial(chunks * stride);
+    std::vector<double> chunkActive(chunks, 0.0), chunkReactive(chunks, 0.0);
+    const double phaseScale = 1000.0 / (std::sqrt(3.0) * BUS_NOMINAL_VOLTAGE);  // kW -> A per phase
+
+    auto work = [&](int first, int step) {
+        for (int c = first; c < chunks; c += step) {
+            std::complex<double>* sums = &partial[c * stride];
+            int end = std::min(count, (c + 1) * BUS_CHUNK);
+            for (int i = c * BUS_CHUNK; i < end; i++) {
+                const MotorState& state = fleet[i];
+                if (!state.isRunning || state.powerConsumption <= 0.0) continue;
+                double pf = std::max(0.05, std::min(1.0, state.powerFactor));
+                double angle = -std::acos(pf);  // Lagging
+                double fundamental = state.powerConsumption * phaseScale / pf;
+                double distortion = 1.0 + 0.5 * (1.0 - std::max(0.0, std::min(1.0, state.load)));
+                std::complex<double>* feederSums = &sums[machineFeeder[i] * BUS_HARMONICS];
+                for (int h = 0; h < BUS_HARMONICS; h++) {
+                    double magnitude = fundamental * BUS_HARMONIC_FRACTION[h] * (h == 0 ? 1.0 : distortion);
+                    feederSums[h] += std::polar(magnitude, BUS_HARMONIC_ORDER[h] * angle);
+                }
+                chunkActive[c] += state.powerConsumption;
+                chunkReactive[c] += state.powerConsumption * std::tan(-angle);
+            }
+        }
+    };
+    int workers = (int)std::max(1u, std::thread::hardware_concurrency());
+    workers = std::max(1, std::min(workers, chunks));
+    std::vector<std::thread> threads;
+    for (int w = 1; w < workers; w++) threads.emplace_back(work, w, workers);
+    work(0, workers);
+    for (std::thread& thread : threads) thread.join();
+
+    // Ordered merge
+    for (BusFeeder& f : busFeeders) {
+        for (int h = 0; h < BUS_HARMONICS; h++) f.current[h] = 0.0;
+    }
+    for (BusTransformer& t : busTransformers) {
+        for (int h = 0; h < BUS_HARMONICS; h++) t.current[h] = 0.0;
+    }
+    plantBus = PlantBus();
+    for (int c = 0; c < chunks; c++) {
+        for (int f = 0; f < feeders; f++) {
+            for (int h = 0; h < BUS_HARMONICS; h++) busFeeders[f].current[h] += partial[c * stride + f * BUS_HARMONICS + h];
+        }
+        plantBus.activeKW += chunkActive[c];
+        plantBus.reactiveKVAR += chunkReactive[c];
+    }
+    for (const BusFeeder& f : busFeeders) {
+        for (int h = 0; h < BUS_HARMONICS; h++) busTransformers[f.transformer].current[h] += f.current[h];
+    }
+
+    // Transformers: loading, K-factor, drop and voltage distortion at the secondary
+    std::complex<double> plantCurrent[BUS_HARMONICS] = {};
+    for (BusTransformer& t : busTransformers) {
+        double baseImpedance = BUS_NOMINAL_VOLTAGE * BUS_NOMINAL_VOLTAGE / (t.ratingKVA * 1000.0);
+        double impedance = t.impedancePercent / 100.0 * baseImpedance;
+        double r = impedance / std::sqrt(1.0 + BUS_TRANSFORMER_XR * BUS_TRANSFORMER_XR), x = r * BUS_TRANSFORMER_XR;
+        double sumSq = 0.0, weighted = 0.0, harmonicVoltageSq = 0.0;
+        for (int h = 0; h < BUS_HARMONICS; h++) {
+            double magnitudeSq = std::norm(t.current[h]);
+            int order = BUS_HARMONIC_ORDER[h];
+            sumSq += magnitudeSq;
+            weighted += magnitudeSq * order * order;
+            if (h > 0) harmonicVoltageSq += magnitudeSq * std::norm(std::complex<double>(r, order * x));
+            plantCurrent[h] += t.current[h];
+        }
+        t.currentRms = std::sqrt(sumSq);
+        t.loadingPercent = 100.0 * std::sqrt(3.0) * BUS_NOMINAL_VOLTAGE * t.currentRms / (t.ratingKVA * 1000.0);
+        t.kFactor = sumSq > 0.0 ? weighted / sumSq : 1.0;
+        t.voltageDropPercent = BusVoltageDropPercent(t.current[0], r, x);
+        t.voltageThdPercent = 100.0 * std::sqrt(harmonicVoltageSq) / (BUS_NOMINAL_VOLTAGE / std::sqrt(3.0));
+    }
+    for (BusFeeder& f : busFeeders) {
+        double sumSq = 0.0;
+        for (int h = 0; h < BUS_HARMONICS; h++) sumSq += std::norm(f.current[h]);
+        f.currentRms = std::sqrt(sumSq);
+        f.voltageDropPercent = busTransformers[f.transformer].voltageDropPercent +
+                               BusVoltageDropPercent(f.current[0], f.resistance, f.reactance);
+    }
+
+    // Plant power factor: displacement from P/Q, true PF adds the distortion term
+    double apparent = std::hypot(plantBus.activeKW, plantBus.reactiveKVAR);
+    double harmonicSq = 0.0;
+    for (int h = 1; h < BUS_HARMONICS; h++) harmonicSq += std::norm(plantCurrent[h]);
+    double fundamental = std::abs(plantCurrent[0]);
+    double thd = fundamental > 0.0 ? std::sqrt(harmonicSq) / fundamental : 0.0;
+    plantBus.displacementPowerFactor = apparent > 0.0 ? plantBus.activeKW / apparent : 0.0;
+    plantBus.truePowerFactor = plantBus.displacementPowerFactor / std::sqrt(1.0 + thd * thd);
+    plantBus.currentThdPercent = 100.0 * thd;
+}
+
+// ========================================================================
+// PROCESS LINES (load coupling over a machine dependency graph)
+// ========================================================================
+// Conveyor chains and pump trains are edges upstream -> downstream with a
+// share of the upstream throughput. Each step a machine's throughput is its
+// load while running (zero when stopped); a machine with feeders blends its
+// own load with what arrives:
+//   load = (1 - coupling) * ownLoad + coupling * sum(share * throughput[up])
+// so a stopped or throttled upstream machine starves everything after it.
+// The graph is compiled on change into flat arrays in topological level
+// order (CSR of incoming edges), and each level is evaluated as one batch,
+// split across threads when it is large. Edges that would close a cycle are
+// rejected.
+
+const double PROCESS_DEFAULT_COUPLING = 0.8;
+const int PROCESS_PARALLEL_MIN = 2048;  // Nodes in a level before it is split across threads
+
+struct ProcessEdge {
+    int upstream, downstream;
+    double share;
+};
+
+struct ProcessGraph {
+    std::vector<ProcessEdge> edges;
+    std::vector<std::vector<int>> downstream;  // Adjacency for cycle checks
+    std::vector<unsigned> visited;
+    unsigned visitStamp;
+    bool compiled;
+    // Compiled form: dependent nodes (in-degree > 0) ordered by level
+    std::vector<int> level;           // Per machine; 0 for sources and unconnected machines
+    std::vector<int> levelStart;      // levelStart[l - 1] = first slot of level l in order, plus end
+    std::vector<int> order;           // Dependent machines by level
+    std::vector<int> inStart;         // Offsets into inSource/inShare, per order slot, plus end
+    std::vector<int> inSource;
+    std::vector<double> inShare;
+};
+
+static ProcessGraph processGraph;
+static std::vector<double> machineThroughput;
+static double processCoupling = PROCESS_DEFAULT_COUPLING;
+
+void ResizeProcessLines(int count) {
+    processGraph.edges.clear();
+    processGraph.downstream.assign(count, std::vector<int>());
+    processGraph.visited.assign(count, 0u);
+    processGraph.visitStamp = 0;
+    processGraph.compiled = false;
+    machineThroughput.assign(count, 0.0);
+}
+
+// True if target is reachable from start along downstream edges. The
+// adjacency is kept incrementally and visits are generation-stamped, so a
+// check costs only the part of the graph it walks.
+bool ProcessReachable(int start, int target) {
+    ProcessGraph& g = processGraph;
+    if (++g.visitStamp == 0) {
+        std::fill(g.visited.begin(), g.visited.end(), 0u);
+        g.visitStamp = 1;
+    }
+    std::vector<int> stack(1, start);
+    g.visited[start] = g.visitStamp;
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        if (node == target) return true;
+        for (int next : g.downstream[node]) {
+            if (g.visited[next] != g.visitStamp) {
+                g.visited[next] = g.visitStamp;
+                stack.push_back(next);
+            }
+        }
+    }
+    return false;
+}
+
+// Kahn's algorithm assigns level = 1 + max(upstream level), then dependent
+// nodes are bucketed by level and their incoming edges laid out in that order
+void CompileProcessGraph() {
+    ProcessGraph& g = processGraph;
+    int count = (int)fleet.size();
+    std::vector<int> inDegree(count, 0), outStart(count + 1, 0), outTarget(g.edges.size());
+    for (const ProcessEdge& e : g.edges) {
+        inDegree[e.downstream]++;
+        outStart[e.upstream + 1]++;
+    }
+    for (int i = 0; i < count; i++) outStart[i + 1] += outStart[i];
+    std::vector<int> fill(outStart.begin(), outStart.end() - 1);
+    for (const ProcessEdge& e : g.edges) outTarget[fill[e.upstream]++] = e.downstream;
+
+    g.level.assign(count, 0);
+    std::vector<int> remaining(inDegree), queue;
+    for (int i = 0; i < count; i++) if (remaining[i] == 0) queue.push_back(i);
+    int maxLevel = 0;
+    for (size_t head = 0; head < queue.size(); head++) {
+        int node = queue[head];
+        for (int k = outStart[node]; k < outStart[node + 1]; k++) {
+            int next = outTarget[k];
+            g.level[next] = std::max(g.level[next], g.level[node] + 1);
+            maxLevel = std::max(maxLevel, g.level[next]);
+            if (--remaining[next] == 0) queue.push_back(next);
+        }
+    }
+
+    // Counting sort of dependent nodes by level (stable, so machine order within a level)
+    g.levelStart.assign(maxLevel + 1, 0);
+    for (int i = 0; i < count; i++) if (g.level[i] > 0) g.levelStart[g.level[i]]++;
+    int offset = 0;
+    for (int l = 1; l <= maxLevel; l++) {
+        int size = g.levelStart[l];
+        g.levelStart[l - 1] = offset;
+        offset += size;
+    }
+    g.levelStart[maxLevel] = offset;
+    g.order.assign(offset, 0);
+    std::vector<int> slot(g.levelStart.begin(), g.levelStart.end());
+    std::vector<int> position(count, -1);
+    for (int i = 0; i < count; i++) {
+        if (g.level[i] > 0) {
+            position[i] = slot[g.level[i] - 1]++;
+            g.order[position[i]] = i;
+        }
+    }
+
+    g.inStart.assign(offset + 1, 0);
+    for (const ProcessEdge& e : g.edges) g.inStart[position[e.downstream] + 1]++;
+    for (int k = 0; k < offset; k++) g.inStart[k + 1] += g.inStart[k];
+    g.inSource.assign(g.edges.size(), 0);
+    g.inShare.assign(g.edges.size(), 0.0);
+    std::vector<int> inFill(g.inStart.begin(), g.inStart.end() - 1);
+    for (const ProcessEdge& e : g.edges) {
+        int k = inFill[position[e.downstream]]++;
+        g.inSource[k] = e.upstream;
+        g.inShare[k] = e.share;
+    }
+    g.compiled = true;
+}
+
+// Levels including level 0 (sources and unconnected machines)
+int ProcessLevelCount() {
+    if (processGraph.edges.empty()) return 1;
+    if (!processGraph.compiled) CompileProcessGraph();
+    return (int)processGraph.levelStart.size();
+}
+
+void UpdateProcessLines() {
+    int count = (int)fleet.size();
+    for (int i = 0; i < count; i++) {
+        machineThroughput[i] = fleet[i].isRunning ? fleet[i].load : 0.0;
+    }
+    if (processGraph.edges.empty()) return;
+    if (!processGraph.compiled) CompileProcessGraph();
+    const ProcessGraph& g = processGraph;
+
+    // Nodes within a level only read earlier levels, so a level is one parallel batch
+    auto evaluate = [&](int first, int last) {
+        for (int k = first; k < last; k++) {
+            int i = g.order[k];
+            MotorState& state = fleet[i];
+            if (!state.isRunning) continue;
+            double supply = 0.0;
+            for (int e = g.inStart[k]; e < g.inStart[k + 1]; e++) {
+                supply += g.inShare[e] * machineThroughput[g.inSource[e]];
+            }
+            double load = (1.0 - processCoupling) * state.load + processCoupling * supply;
+            state.load = std::max(0.1, std::min(1.0, load));
+            machineThroughput[i] = state.load;
+        }
+    };
+    int hardware = (int)std::max(1u, std::thread::hardware_concurrency());
+    for (int l = 0; l + 1 < (int)g.levelStart.size(); l++) {
+        int first = g.levelStart[l], last = g.levelStart[l + 1];  // Level l + 1
+        int workers = std::max(1, std::min(hardware, (last - first) / PROCESS_PARALLEL_MIN));
+        if (workers == 1) {
+            evaluate(first, last);
+            continue;
+        }
+        int span = (last - first + workers - 1) / workers;
+        std::vector<std::thread> threads;
+        for (int w = 1; w < workers; w++) {
+            threads.emplace_back(evaluate, std::min(last, first + w * span), std::min(last, first + (w + 1) * span));
+        }
+        evaluate(first, std::min(last, first + span));
+        for (std::thread& thread : threads) thread.join();
+    }
+}
+
+// ========================================================================
+// PLANT ENVIRONMENT (weather, day/night, season, zone ambient)
+// ========================================================================
+// Outdoor conditions are computed once per step from the simulated clock:
+//   temperature = annual mean + seasonal cosine + diurnal cosine + weather
+//   humidity    = falls as the day warms, plus weather
+//   pressure    = sea-level pressure plus a slow synoptic swing
+// Weather anomalies are AR(1) processes with multi-day time constants from
+// a fixed-seed generator, so a run is reproducible. Each plant zone mixes
+// outdoor air with its HVAC setpoint and adds its process heat; machines
+// reference a zone by index and read its conditions while they step.
+
+const double ENV_DAY_SECONDS = 86400.0;
+const double ENV_YEAR_DAYS = 365.0;
+const double ENV_COLDEST_DAY = 15.0;            // Day of year of the seasonal minimum
+const double ENV_WARMEST_HOUR = 15.0;           // Hour of the diurnal maximum
+const double ENV_WEATHER_TIME_CONSTANT = 2.0 * ENV_DAY_SECONDS;
+const double ENV_WEATHER_STD = 3.0;             // °C
+const double ENV_HUMIDITY_STD = 8.0;            // % RH
+const double ENV_PRESSURE_TIME_CONSTANT = 3.0 * ENV_DAY_SECONDS;
+const double ENV_PRESSURE_STD = 1.0;            // kPa
+const double ENV_SEA_LEVEL_PRESSURE = 101.325;  // kPa
+
+struct SiteClimate {
+    double annualMean, annualAmplitude, dailyAmplitude;  // °C
+    double meanHumidity;                                 // % RH
+};
+
+struct PlantZone {
+    double outdoorCoupling;  // 0 = fully conditioned, 1 = open to outdoor air
+    double setpoint;         // °C - HVAC setpoint
+    double heatGain;         // °C - Process heat above the mixed temperature
+    AmbientConditions conditions;
+};
+
+static SiteClimate siteClimate = { 12.0, 9.0, 5.0, 70.0 };
+static std::vector<PlantZone> plantZones;
+static std::vector<int> machineZone;
+static AmbientConditions outdoorConditions;
+static double weatherTemperature = 0.0, weatherHumidity = 0.0, weatherPressure = 0.0;
+static uint64_t environmentRngState = 0x2545F4914F6CDD1Dull;
+
+// Standard normal from a dedicated xorshift64 stream (Box-Muller)
+double EnvironmentNormal() {
+    auto uniform = []() {
+        environmentRngState ^= environmentRngState << 13;
+        environmentRngState ^= environmentRngState >> 7;
+        environmentRngState ^= environmentRngState << 17;
+        return ((environmentRngState >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+    };
+    double u1 = uniform(), u2 = uniform();
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(VIB_TWO_PI * u2);
+}
+
+// One AR(1) step of length dt toward zero with stationary deviation std
+double WeatherStep(double anomaly, double dtSeconds, double timeConstant, double std) {
+    double phi = std::exp(-dtSeconds / timeConstant);
+    return phi * anomaly + std * std::sqrt(1.0 - phi * phi) * EnvironmentNormal();
+}
+
+void ComputeZoneConditions(PlantZone& zone) {
+    double mixed = zone.outdoorCoupling * outdoorConditions.temperature + (1.0 - zone.outdoorCoupling) * zone.setpoint;
+    zone.conditions = outdoorConditions;
+    zone.conditions.temperature = mixed + zone.heatGain;
+    // Same moisture content: relative humidity drops ~5% per °C of warming
+    double warming = zone.conditions.temperature - outdoorConditions.temperature;
+    zone.conditions.humidity = std::max(5.0, std::min(100.0, outdoorConditions.humidity * std::pow(0.95, warming)));
+}
+
+// Conditions at simulated time fleetSimTime + dtSeconds (the end of the step being taken)
+void UpdateEnvironment(double dtSeconds) {
+    if (dtSeconds > 0.0) {
+        weatherTemperature = WeatherStep(weatherTemperature, dtSeconds, ENV_WEATHER_TIME_CONSTANT, ENV_WEATHER_STD);
+        weatherHumidity = WeatherStep(weatherHumidity, dtSeconds, ENV_WEATHER_TIME_CONSTANT, ENV_HUMIDITY_STD);
+        weatherPressure = WeatherStep(weatherPressure, dtSeconds, ENV_PRESSURE_TIME_CONSTANT, ENV_PRESSURE_STD);
+    }
+    double dayOfYear = std::fmod(PlantDays(fleetSimTime + dtSeconds), ENV_YEAR_DAYS);
+    double hourOfDay = PlantHourOfDay(fleetSimTime + dtSeconds);
+    double seasonal = -std::cos(VIB_TWO_PI * (dayOfYear - ENV_COLDEST_DAY) / ENV_YEAR_DAYS);  // -1 winter, +1 summer
+    double diurnal = std::cos(VIB_TWO_PI * (hourOfDay - ENV_WARMEST_HOUR) / 24.0);            // +1 mid-afternoon
+
+    outdoorConditions.temperature = siteClimate.annualMean + siteClimate.annualAmplitude * seasonal +
+                                    siteClimate.dailyAmplitude * diurnal + weatherTemperature;
+    outdoorConditions.humidity = std::max(5.0, std::min(100.0,
+        siteClimate.meanHumidity - 2.5 * siteClimate.dailyAmplitude * diurnal + weatherHumidity));
+    outdoorConditions.pressure = ENV_SEA_LEVEL_PRESSURE + weatherPressure;
+    outdoorConditions.hourOfDay = hourOfDay;
+    outdoorConditions.seasonalFactor = 1.0 + 0.15 * seasonal;
+    for (PlantZone& zone : plantZones) ComputeZoneConditions(zone);
+}
+
+void ResizeEnvironment(int count) {
+    if (plantZones.empty()) {
+        // Zone 0: production hall, partly conditioned with some process heat
+        plantZones.push_back({ 0.3, 22.0, 4.0, AmbientConditions() });
+        UpdateEnvironment(0.0);
+    }
+    machineZone.assign(count, 0);
+}
+
+const AmbientConditions& MachineAmbient(int index) {
+    return plantZones[machineZone[index]].conditions;
+}
+
+// ========================================================================
+// DUTY-CYCLE SCHEDULES (IEC 60034-1 S1-S10)
+// ========================================================================
+// A duty profile is a repeating sequence of segments, each with a run flag
+// and linear load and speed-factor ramps. Profiles are compiled into flat
+// per-segment arrays (start value and slope, plus the index of the next
+// segment), and every scheduled machine keeps a cursor: current segment
+// and time into it. A step advances the cursor by dt, crossing segment ends
+// as needed (whole periods are skipped with one fmod), so evaluation is
+// O(1) per machine without searching the schedule.
+//
+// Before the physics a scheduled machine's run state follows its segment
+// (rest segments stop it); after the physics its load and speed are
+// replaced by the segment values, so the process-line and electrical
+// models downstream see the scheduled operating point. A profile owns the
+// machine's run state: Start/StopMachine are overridden at the next step.
+
+const int DUTY_S1 = 1, DUTY_S10 = 10;
+const double DUTY_IDLE_LOAD = 0.1;        // Running with no load (physics minimum)
+const double DUTY_START_FRACTION = 0.25;  // Share of on-time spent starting/braking (S4, S5, S7)
+const double DUTY_CRAWL_SPEED = 0.1;      // Speed factor at the ends of start/brake ramps
+const int DUTY_RANDOM_SEGMENTS = 24;      // S9 load levels per period
+
+struct DutySegment {
+    double duration, loadStart, loadEnd, speedStart, speedEnd;
+    bool running;
+};
+
+struct DutyTables {
+    std::vector<int> profileFirst;    // First segment of each profile
+    std::vector<double> period;       // Per profile, s
+    std::vector<double> duration, load, loadSlope, speed, speedSlope;  // Per segment
+    std::vector<char> running;
+    std::vector<int> next;            // Following segment, wrapping within the profile
+};
+
+static DutyTables duty;
+static std::vector<int> machineDutyProfile;    // -1 = unscheduled
+static std::vector<int> machineDutySegment;
+static std::vector<double> machineDutyElapsed;  // s into the current segment
+
+void ResizeDutyCycles(int count) {
+    machineDutyProfile.assign(count, -1);
+    machineDutySegment.assign(count, 0);
+    machineDutyElapsed.assign(count, 0.0);
+}
+
+// Appends a profile to the flat tables; returns its index
+int CompileDutyProfile(const std::vector<DutySegment>& segments) {
+    int first = (int)duty.duration.size();
+    double period = 0.0;
+    for (int k = 0; k < (int)segments.size(); k++) {
+        const DutySegment& s = segments[k];
+        duty.duration.push_back(s.duration);
+        duty.load.push_back(s.loadStart);
+        duty.loadSlope.push_back((s.loadEnd - s.loadStart) / s.duration);
+        duty.speed.push_back(s.speedStart);
+        duty.speedSlope.push_back((s.speedEnd - s.speedStart) / s.duration);
+        duty.running.push_back(s.running ? 1 : 0);
+        duty.next.push_back(k + 1 < (int)segments.size() ? first + k + 1 : first);
+        period += s.duration;
+    }
+    duty.profileFirst.push_back(first);
+    duty.period.push_back(period);
+    return (int)duty.profileFirst.size() - 1;
+}
+
+// Standard shapes for one period. dutyFactor is the on-time share (S2-S5,
+// S6 loaded share); load is the rated-load fraction while working.
+std::vector<DutySegment> StandardDutySegments(int type, double period, double dutyFactor, double load) {
+    double on = period * dutyFactor, off = period - on;
+    double ramp = on * DUTY_START_FRACTION;
+    DutySegment rest = { off, 0.0, 0.0, 0.0, 0.0, false };
+    DutySegment start = { ramp, load, load, DUTY_CRAWL_SPEED, 1.0, true };
+    DutySegment brake = { ramp, load, DUTY_IDLE_LOAD, 1.0, DUTY_CRAWL_SPEED, true };
+    std::vector<DutySegment> segments;
+    switch (type) {
+        case 1:  // S1 continuous
+            segments = { { period, load, load, 1.0, 1.0, true } };
+            break;
+        case 2:  // S2 short-time, then rest long enough to cool (one period approximates it)
+        case 3:  // S3 intermittent periodic
+            segments = { { on, load, load, 1.0, 1.0, true }, rest };
+            break;
+        case 4:  // S4 intermittent periodic with starting
+            segments = { start, { on - ramp, load, load, 1.0, 1.0, true }, rest };
+            break;
+        case 5:  // S5 intermittent periodic with electric braking
+            segments = { start, { on - 2.0 * ramp, load, load, 1.0, 1.0, true }, brake, rest };
+            break;
+        case 6:  // S6 continuous with no-load periods
+            segments = { { on, load, load, 1.0, 1.0, true }, { off, DUTY_IDLE_LOAD, DUTY_IDLE_LOAD, 1.0, 1.0, true } };
+            break;
+        case 7:  // S7 continuous with starting and braking (no rest)
+            ramp = period * DUTY_START_FRACTION * 0.5;
+            segments = { { ramp, load, load, DUTY_CRAWL_SPEED, 1.0, true }, { period - 2.0 * ramp, load, load, 1.0, 1.0, true },
+                         { ramp, load, DUTY_IDLE_LOAD, 1.0, DUTY_CRAWL_SPEED, true } };
+            break;
+        case 8:  // S8 continuous with related load/speed changes
+            segments = { { period * 0.4, load, load, 1.0, 1.0, true },
+                         { period * 0.3, load * 0.6, load * 0.6, 0.8, 0.8, true },
+                         { period * 0.3, std::min(1.0, load * 1.2), std::min(1.0, load * 1.2), 1.1, 1.1, true } };
+            break;
+        case 9: {  // S9 non-periodic load and speed variations (levels repeat after one period)
+            uint64_t hash = 0x9E3779B97F4A7C15ull * (uint64_t)(duty.profileFirst.size() + 1);
+            auto level = [&hash]() {
+                hash ^= hash << 13; hash ^= hash >> 7; hash ^= hash << 17;
+                return (hash >> 11) * (1.0 / 9007199254740992.0);
+            };
+            double previousLoad = load, previousSpeed = 1.0;
+            for (int k = 0; k < DUTY_RANDOM_SEGMENTS; k++) {
+                double nextLoad = k + 1 < DUTY_RANDOM_SEGMENTS ? std::max(DUTY_IDLE_LOAD, std::min(1.0, load * (0.4 + 0.9 * level()))) : load;
+                double nextSpeed = k + 1 < DUTY_RANDOM_SEGMENTS ? 0.8 + 0.3 * level() : 1.0;
+                segments.push_back({ period / DUTY_RANDOM_SEGMENTS, previousLoad, nextLoad, previousSpeed, nextSpeed, true });
+                previousLoad = nextLoad;
+                previousSpeed = nextSpeed;
+            }
+            break;
+        }
+        case 10:  // S10 discrete constant loads
+            segments = { { period * 0.4, load, load, 1.0, 1.0, true },
+                         { period * 0.3, load * 0.6, load * 0.6, 1.0, 1.0, true },
+                         { period * 0.2, std::min(1.0, load * 1.15), std::min(1.0, load * 1.15), 1.0, 1.0, true },
+                         { period * 0.1, load * 0.35, load * 0.35, 1.0, 1.0, true } };
+            break;
+    }
+    // Zero-length pieces (dutyFactor 0 or 1) would stall the cursor
+    segments.erase(std::remove_if(segments.begin(), segments.end(),
+                                  [](const DutySegment& s) { return s.duration <= 0.0; }), segments.end());
+    return segments;
+}
+
+// Moves a cursor on to time t + dt within its profile
+void AdvanceDutyCursor(int& segment, double& elapsed, int profile, double dtSeconds) {
+    elapsed += std::fmod(dtSeconds, duty.period[profile]);
+    while (elapsed >= duty.duration[segment]) {
+        elapsed -= duty.duration[segment];
+        segment = duty.next[segment];
+    }
+}
+
+// Before the physics: advance cursors to the end of the step and set run state
+void AdvanceDutyCycles(double dtSeconds) {
+    for (int i = 0; i < (int)machineDutyProfile.size(); i++) {
+        int profile = machineDutyProfile[i];
+        if (profile < 0) continue;
+        AdvanceDutyCursor(machineDutySegment[i], machineDutyElapsed[i], profile, dtSeconds);
+        fleet[i].isRunning = duty.running[machineDutySegment[i]] != 0;
+    }
+}
+
+double MachineDutyLoad(int index) {
+    int segment = machineDutySegment[index];
+    return duty.load[segment] + duty.loadSlope[segment] * machineDutyElapsed[index];
+}
+
+// After the physics: scheduled operating point replaces the statistical one
+void ApplyDutyCycles() {
+    for (int i = 0; i < (int)machineDutyProfile.size(); i++) {
+        if (machineDutyProfile[i] < 0 || !fleet[i].isRunning) continue;
+        int segment = machineDutySegment[i];
+        double speedFactor = duty.speed[segment] + duty.speedSlope[segment] * machineDutyElapsed[i];
+        MotorState& state = fleet[i];
+        state.load = std::max(DUTY_IDLE_LOAD, std::min(1.0, MachineDutyLoad(i)));
+        state.speed *= speedFactor;
+        state.rpm = state.speed;
+    }
+}
+
+// ========================================================================
+// BEHAVIOR SCRIPTS (C++20 coroutines on simulated time)
+// ========================================================================
+// Per-motor procedures (maintenance, shift patterns) are coroutines that
+// suspend on simulated-time awaits: `co_await ScriptDelay{seconds}`. One
+// scheduler keeps a min-heap of wake-ups ordered by (time, sequence) and, at
+// the start of each fleet step, resumes every script due by then in that
+// order, so runs are deterministic. A delay of 0 resumes at the next step.
+// Coroutine frames come from a pool of fixed size classes with free lists,
+// so starting and finishing scripts does not touch the global heap once the
+// pool is warm; 100k concurrent scripts cost one frame and one heap entry
+// each. Scripts are destroyed when the fleet is resized.
+// Script ids carry the slot's epoch above the slot number, so an id stays
+// dead after its slot is reused (until the epoch field wraps, 2048 reuses
+// of the same slot later).
+//
+// Coroutine machinery needs C++ linkage, hence the extern "C++" block.
+
+extern "C++" {
+
+const size_t SCRIPT_FRAME_ALIGN = 64;        // Size-class granularity, bytes
+const int SCRIPT_FRAME_CLASSES = 16;         // Pooled frames up to 1 KB
+const int SCRIPT_FRAMES_PER_CHUNK = 256;
+const int SCRIPT_MAINTENANCE_RAMP_STEPS = 10;
+const int SCRIPT_SLOT_BITS = 20;             // Up to ~1M concurrent scripts
+const int SCRIPT_SLOT_MASK = (1 << SCRIPT_SLOT_BITS) - 1;
+const uint32_t SCRIPT_EPOCH_MASK = 0x7FF;    // Epoch bits that fit above the slot in a non-negative int
+
+struct ScriptFramePool {
+    std::vector<void*> freeFrames[SCRIPT_FRAME_CLASSES];
+    std::vector<std::unique_ptr<char[]>> chunks;
+};
+
+static ScriptFramePool scriptFramePool;
+
+void* AllocateScriptFrame(size_t size) {
+    size_t sizeClass = (size + SCRIPT_FRAME_ALIGN - 1) / SCRIPT_FRAME_ALIGN;
+    if (sizeClass == 0 || sizeClass > (size_t)SCRIPT_FRAME_CLASSES) return ::operator new(size);
+    std::vector<void*>& freeList = scriptFramePool.freeFrames[sizeClass - 1];
+    if (freeList.empty()) {
+        size_t blockBytes = sizeClass * SCRIPT_FRAME_ALIGN;
+        scriptFramePool.chunks.emplace_back(new char[blockBytes * SCRIPT_FRAMES_PER_CHUNK]);
+        char* chunk = scriptFramePool.chunks.back().get();
+        for (int b = SCRIPT_FRAMES_PER_CHUNK - 1; b >= 0; b--) freeList.push_back(chunk + b * blockBytes);
+    }
+    void* frame = freeList.back();
+    freeList.pop_back();
+    return frame;
+}
+
+void ReleaseScriptFrame(void* frame, size_t size) {
+    size_t sizeClass = (size + SCRIPT_FRAME_ALIGN - 1) / SCRIPT_FRAME_ALIGN;
+    if (sizeClass == 0 || sizeClass > (size_t)SCRIPT_FRAME_CLASSES) {
+        ::operator delete(frame);
+        return;
+    }
+    scriptFramePool.freeFrames[sizeClass - 1].push_back(frame);
+}
+
+// Lazily started (the scheduler runs the body) and kept alive after the
+// final suspend so the scheduler decides when the frame is released
+struct BehaviorTask {
+    struct promise_type {
+        BehaviorTask get_return_object() { return { std::coroutine_handle<promise_type>::from_promise(*this) }; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+        static void* operator new(size_t size) { return AllocateScriptFrame(size); }
+        static void operator delete(void* frame, size_t size) { ReleaseScriptFrame(frame, size); }
+    };
+    std::coroutine_handle<promise_type> handle;
+};
+
+struct ScriptWake {
+    double time;
+    uint64_t sequence;
+    int slot;
+    uint32_t epoch;
+};
+
+// priority_queue is a max-heap: "later" entries sink
+struct ScriptWakeLater {
+    bool operator()(const ScriptWake& a, const ScriptWake& b) const {
+        return a.time != b.time ? a.time > b.time : a.sequence > b.sequence;
+    }
+};
+
+struct ScriptSlot {
+    std::coroutine_handle<BehaviorTask::promise_type> handle;
+    uint32_t epoch;  // Bumped on release so stale wake-ups are skipped
+};
+
+static std::vector<ScriptSlot> scriptSlots;
+static std::vector<int> freeScriptSlots;
+static std::priority_queue<ScriptWake, std::vector<ScriptWake>, ScriptWakeLater> scriptWakes;
+static uint64_t scriptSequence = 0;
+static int runningScript = -1;
+static int activeScripts = 0;
+static std::vector<double> scriptSpeedFactor;  // Per machine; < 1 while a script ramps it up
+
+void ScheduleScript(int slot, double time) {
+    scriptWakes.push({ time, scriptSequence++, slot, scriptSlots[slot].epoch });
+}
+
+// co_await ScriptDelay{seconds} suspends the running script on simulated time
+struct ScriptDelay {
+    double seconds;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<>) const { ScheduleScript(runningScript, fleetSimTime + std::max(0.0, seconds)); }
+    void await_resume() const noexcept {}
+};
+
+// Returns the script id, or -1 when every slot is taken
+int LaunchScript(BehaviorTask task) {
+    int slot;
+    if (!freeScriptSlots.empty()) {
+        slot = freeScriptSlots.back();
+        freeScriptSlots.pop_back();
+        scriptSlots[slot].handle = task.handle;
+    } else if (scriptSlots.size() <= (size_t)SCRIPT_SLOT_MASK) {
+        slot = (int)scriptSlots.size();
+        scriptSlots.push_back({ task.handle, 0u });
+    } else {
+        task.handle.destroy();
+        return -1;
+    }
+    activeScripts++;
+    ScheduleScript(slot, fleetSimTime);
+    return (int)((scriptSlots[slot].epoch & SCRIPT_EPOCH_MASK) << SCRIPT_SLOT_BITS) | slot;
+}
+
+// Slot of a live script id, or -1 for ids that are malformed, finished or cancelled
+int FindScriptSlot(int script) {
+    if (script < 0) return -1;
+    int slot = script & SCRIPT_SLOT_MASK;
+    uint32_t epoch = (uint32_t)script >> SCRIPT_SLOT_BITS;
+    if (slot >= (int)scriptSlots.size() || !scriptSlots[slot].handle) return -1;
+    return (scriptSlots[slot].epoch & SCRIPT_EPOCH_MASK) == epoch ? slot : -1;
+}
+
+void ReleaseScript(int slot) {
+    scriptSlots[slot].handle.destroy();
+    scriptSlots[slot].handle = nullptr;
+    scriptSlots[slot].epoch++;
+    freeScriptSlots.push_back(slot);
+    activeScripts--;
+}
+
+// Start of a step: resume everything due by now, in (time, sequence) order.
+// Wake-ups queued during this pass wait for the next step.
+void RunBehaviorScripts() {
+    uint64_t passStart = scriptSequence;
+    while (!scriptWakes.empty()) {
+        ScriptWake wake = scriptWakes.top();
+        if (wake.time > fleetSimTime || wake.sequence >= passStart) break;
+        scriptWakes.pop();
+        ScriptSlot& slot = scriptSlots[wake.slot];
+        if (slot.epoch != wake.epoch) continue;  // Cancelled
+        runningScript = wake.slot;
+        slot.handle.resume();
+        runningScript = -1;
+        if (scriptSlots[wake.slot].handle.done()) ReleaseScript(wake.slot);
+    }
+}
+
+void ResizeBehaviorScripts(int count) {
+    for (int s = 0; s < (int)scriptSlots.size(); s++) {
+        if (scriptSlots[s].handle) ReleaseScript(s);
+    }
+    scriptWakes = decltype(scriptWakes)();
+    scriptSpeedFactor.assign(count, 1.0);
+}
+
+// After the physics: scripted speed limits (ramp-ups) cap the operating point
+void ApplyBehaviorOverrides() {
+    for (int i = 0; i < (int)scriptSpeedFactor.size(); i++) {
+        if (scriptSpeedFactor[i] >= 1.0 || !fleet[i].isRunning) continue;
+        fleet[i].speed *= scriptSpeedFactor[i];
+        fleet[i].rpm = fleet[i].speed;
+    }
+}
+
+// Gives a machine its full speed back when the script that limits it ends,
+// whether it finishes or is cancelled mid-ramp (destroying the frame runs it)
+struct ScriptSpeedGuard {
+    int machine;
+    ~ScriptSpeedGuard() { scriptSpeedFactor[machine] = 1.0; }
+};
+
+// Stop, service (fresh oil), restart and ramp speed back up in equal steps
+BehaviorTask MaintenanceScript(int machine, double downtimeSeconds, double rampSeconds) {
+    ScriptSpeedGuard speedGuard{ machine };
+    fleet[machine].isRunning = false;
+    co_await ScriptDelay{ downtimeSeconds };
+    fleet[machine].oilDegradation = 0.0;
+    fleet[machine].isRunning = true;
+    for (int k = 1; k <= SCRIPT_MAINTENANCE_RAMP_STEPS; k++) {
+        scriptSpeedFactor[machine] = (double)k / SCRIPT_MAINTENANCE_RAMP_STEPS;
+        if (k < SCRIPT_MAINTENANCE_RAMP_STEPS) co_await ScriptDelay{ rampSeconds / SCRIPT_MAINTENANCE_RAMP_STEPS };
+    }
+}
+
+// Run during [startHour, startHour + hours) every day on the plant clock
+BehaviorTask ShiftScript(int machine, double startHour, double shiftHours) {
+    while (true) {
+        double sinceStart = std::fmod(PlantHourOfDay(fleetSimTime) - startHour + 24.0, 24.0);
+        if (sinceStart < shiftHours) {
+            fleet[machine].isRunning = true;
+            co_await ScriptDelay{ (shiftHours - sinceStart) * 3600.0 };
+        } else {
+            fleet[machine].isRunning = false;
+            co_await ScriptDelay{ (24.0 - sinceStart) * 3600.0 };
+        }
+    }
+}
+
+}  // extern "C++"
+
+// ========================================================================
+// FLEET LIFECYCLE
+// ========================================================================
+
+// Size every fleet subsystem for the given machine count
+void ResizeFleet(int count) {
+    InitializeMotor();
+    fleet.assign(count, motor);
+    fleetSimTime = 0.0;
+    ResizeOEEAccumulators(count);
+    ResizeEnergyAccumulators(count);
+    ResizeStateLogs(count);
+    ResizeStatusBits(count);
+    ResizeRiskHeaps(count);
+    ResizeAnomalyModels(count);
+    ResizeKalmanFilters(count);
+    ResizeThermalRLS(count);
+    ResizeForecasters(count);
+    ResizeSnapshotFeatures(count);
+    ResizeMLScores(count);
+    ResizeVibrationFeatures(count);
+    ResetSnapshotHistory();
+    ResizeIsolationScores(count);
+    ResizeSpectralSignatures(count);
+    ResizeAcousticChannels(count);
+    ResizeThermalNetwork(count);
+    ResizeHousingGrids(count);
+    ResizeRotorDynamics(count);
+    ResizeElectricalModel(count);
+    ResizeElectricalBus(count);
+    ResizeProcessLines(count);
+    ResizeEnvironment(count);
+    ResizeDutyCycles(count);
+    ResizeBehaviorScripts(count);
+}
+
+// Record a start/stop or status change made outside of fleet stepping
+void RefreshMachineStatus(int index) {
+    TransitionMachineState(index, ClassifyMachineState(fleet[index]), fleetSimTime);
+    UpdateMachineStatusBits(index);
+}
+
+void InitializeFleet() {
+    InitializeMotor();
+    if (fleet.empty()) {
+        ResizeFleet(motor.machineCount);
+    }
+}
+
+// ========================================================================
+// C API FUNCTIONS FOR C# BACKEND
+// ========================================================================
+
+// Basic motor parameters
+extern "C" double GetMotorSpeed() {
+    UpdateMotorPhysics();
+    return motor.speed;
+}
+
+extern "C" double GetMotorTemperature() {
+    UpdateMotorPhysics();
+    return motor.temperature;
+}
+
+extern "C" double GetMotorEfficiency() {
+    UpdateMotorPhysics();
+    return motor.efficiency;
+}
+
+extern "C" double GetMotorPowerConsumption() {
+    UpdateMotorPhysics();
+    return motor.powerConsumption;
+}
+
+extern "C" double GetMotorVibration() {
+    UpdateMotorPhysics();
+    return motor.vibration;
+}
+
+extern "C" double GetMotorLoad() {
+    UpdateMotorPhysics();
+    return motor.load;
+}
+
+extern "C" double GetMotorBearingWear() {
+    UpdateMotorPhysics();
+    return motor.bearingWear;
+}
+
+extern "C" double GetMotorOilDegradation() {
+    UpdateMotorPhysics();
+    return motor.oilDegradation;
+}
+
+extern "C" double GetMotorOperatingHours() {
+    UpdateMotorPhysics();
+    return motor.operatingHours;
+}
+
+// 3-axis vibration sensors
+extern "C" double GetVibrationX() {
+    UpdateMotorPhysics();
+    return motor.vibrationX;
+}
+
+extern "C" double GetVibrationY() {
+    UpdateMotorPhysics();
+    return motor.vibrationY;
+}
+
+extern "C" double GetVibrationZ() {
+    UpdateMotorPhysics();
+    return motor.vibrationZ;
+}
+
+// Pressure sensors
+extern "C" double GetOilPressure() {
+    UpdateMotorPhysics();
+    return motor.oilPressure;
+}
+
+extern "C" double GetAirPressure() {
+    UpdateMotorPhysics();
+    return motor.airPressure;
+}
+
+extern "C" double GetHydraulicPressure() {
+    UpdateMotorPhysics();
+    return motor.hydraulicPressure;
+}
+
+// Flow rate sensors
+extern "C" double GetCoolantFlowRate() {
+    UpdateMotorPhysics();
+    return motor.coolantFlowRate;
+}
+
+extern "C" double GetFuelFlowRate() {
+    UpdateMotorPhysics();
+    return motor.fuelFlowRate;
+}
+
+// Electrical monitoring
+extern "C" double GetVoltage() {
+    UpdateMotorPhysics();
+    return motor.voltage;
+}
+
+extern "C" double GetCurrent() {
+    UpdateMotorPhysics();
+    return motor.current;
+}
+
+extern "C" double GetPowerFactor() {
+    UpdateMotorPhysics();
+    return motor.powerFactor;
+}
+
+extern "C" double GetPowerConsumption() {
+    UpdateMotorPhysics();
+    return motor.powerConsumption;
+}
+
+// Mechanical measurements
+extern "C" double GetRPM() {
+    UpdateMotorPhysics();
+    return motor.rpm;
+}
+
+extern "C" double GetTorque() {
+    UpdateMotorPhysics();
+    return motor.torque;
+}
+
+extern "C" double GetEfficiency() {
+    UpdateMotorPhysics();
+    return motor.efficiency;
+}
+
+// Environmental sensors
+extern "C" double GetHumidity() {
+    UpdateMotorPhysics();
+    return motor.humidity;
+}
+
+extern "C" double GetAmbientTemperature() {
+    UpdateMotorPhysics();
+    return motor.ambientTemperature;
+}
+
+extern "C" double GetAmbientPressure() {
+    UpdateMotorPhysics();
+    return motor.ambientPressure;
+}
+
+// Position sensors
+extern "C" double GetShaftPosition() {
+    UpdateMotorPhysics();
+    return motor.shaftPosition;
+}
+
+extern "C" double GetDisplacement() {
+    UpdateMotorPhysics();
+    return motor.displacement;
+}
+
+// Strain sensors
+extern "C" double GetStrainGauge1() {
+    UpdateMotorPhysics();
+    return motor.strainGauge1;
+}
+
+extern "C" double GetStrainGauge2() {
+    UpdateMotorPhysics();
+    return motor.strainGauge2;
+}
+
+extern "C" double GetStrainGauge3() {
+    UpdateMotorPhysics();
+    return motor.strainGauge3;
+}
+
+// Acoustic sensors
+extern "C" double GetSoundLevel() {
+    UpdateMotorPhysics();
+    return motor.soundLevel;
+}
+
+extern "C" double GetBearingHealth() {
+    UpdateMotorPhysics();
+    return motor.bearingHealth;
+}
+
+// System status
+extern "C" int GetOperatingHours() {
+    UpdateMotorPhysics();
+    return (int)motor.operatingHours;
+}
+
+extern "C" int GetMaintenanceStatus() {
+    UpdateMotorPhysics();
+    return motor.maintenanceStatus;
+}
+
+extern "C" double GetSystemHealth() {
+    UpdateMotorPhysics();
+    return motor.systemHealth;
+}
+
+// Daily Life Applications
+extern "C" double GetHVACEfficiency() {
+    UpdateMotorPhysics();
+    return motor.hvacEfficiency;
+}
+
+extern "C" double GetEnergySavings() {
+    UpdateMotorPhysics();
+    return motor.energySavings;
+}
+
+extern "C" double GetComfortLevel() {
+    UpdateMotorPhysics();
+    return motor.comfortLevel;
+}
+
+extern "C" double GetAirQuality() {
+    UpdateMotorPhysics();
+    return motor.airQuality;
+}
+
+extern "C" int GetSmartDevices() {
+    UpdateMotorPhysics();
+    return motor.smartDevices;
+}
+
+extern "C" double GetFuelEfficiency() {
+    UpdateMotorPhysics();
+    return motor.fuelEfficiency;
+}
+
+extern "C" double GetEngineHealth() {
+    UpdateMotorPhysics();
+    return motor.engineHealth;
+}
+
+extern "C" double GetBatteryLevel() {
+    UpdateMotorPhysics();
+    return motor.batteryLevel;
 }
 
 extern "C" double GetTirePressure() {
@@ -971,100 +5622,1459 @@ extern "C" double GetTirePressure() {
     return motor.tirePressure;
 }
 
-extern "C" double GetBoatEngineEfficiency() {
-    UpdateMotorPhysics();
-    return motor.boatEngineEfficiency;
+extern "C" double GetBoatEngineEfficiency() {
+    UpdateMotorPhysics();
+    return motor.boatEngineEfficiency;
+}
+
+extern "C" int GetBoatEngineHours() {
+    UpdateMotorPhysics();
+    return motor.boatEngineHours;
+}
+
+extern "C" double GetBladeSharpness() {
+    UpdateMotorPhysics();
+    return motor.bladeSharpness;
+}
+
+extern "C" double GetFuelLevel() {
+    UpdateMotorPhysics();
+    return motor.fuelLevel;
+}
+
+extern "C" double GetGeneratorPowerOutput() {
+    UpdateMotorPhysics();
+    return motor.generatorPowerOutput;
+}
+
+extern "C" double GetGeneratorFuelEfficiency() {
+    UpdateMotorPhysics();
+    return motor.generatorFuelEfficiency;
+}
+
+extern "C" double GetPoolPumpFlowRate() {
+    UpdateMotorPhysics();
+    return motor.poolPumpFlowRate;
+}
+
+extern "C" double GetPoolPumpEnergyUsage() {
+    UpdateMotorPhysics();
+    return motor.poolPumpEnergyUsage;
+}
+
+extern "C" double GetWashingMachineEfficiency() {
+    UpdateMotorPhysics();
+    return motor.washingMachineEfficiency;
+}
+
+extern "C" double GetDishwasherEfficiency() {
+    UpdateMotorPhysics();
+    return motor.dishwasherEfficiency;
+}
+
+extern "C" double GetRefrigeratorEfficiency() {
+    UpdateMotorPhysics();
+    return motor.refrigeratorEfficiency;
+}
+
+extern "C" double GetAirConditionerEfficiency() {
+    UpdateMotorPhysics();
+    return motor.airConditionerEfficiency;
+}
+
+// Industrial Machine Functions
+extern "C" int GetIndustrialMachineCount() {
+    UpdateMotorPhysics();
+    return motor.machineCount;
+}
+
+extern "C" bool GetMachineRunning(int index) {
+    UpdateMotorPhysics();
+    return motor.isRunning;
+}
+
+extern "C" double GetMachineLoad(int index) {
+    UpdateMotorPhysics();
+    return motor.load;
+}
+
+// Motor control functions
+extern "C" void StartMotor() {
+    UpdateMotorPhysics();
+    motor.isRunning = true;
+}
+
+extern "C" void StopMotor() {
+    UpdateMotorPhysics();
+    motor.isRunning = false;
+}
+
+extern "C" void ResetMotorState() {
+    InitializeMotor();
+}
+
+// Reset physics update flag - call this after reading all values for one sample
+extern "C" void ResetPhysicsUpdateFlag() {
+    physicsUpdatedThisReading = false;
+}
+
+// Fleet simulation functions
+// Returns 1, or -1 when the fleet cannot be allocated (the previous size is kept)
+extern "C" int SetFleetSize(int count) {
+    int previous = (int)fleet.size();
+    try {
+        ResizeFleet(std::max(0, count));
+        return 1;
+    } catch (const std::bad_alloc&) {
+        // Never let the exception cross the C boundary; restore a consistent fleet
+        try {
+            ResizeFleet(previous);
+        } catch (const std::bad_alloc&) {
+            ResizeFleet(0);
+        }
+        return -1;
+    }
+}
+
+extern "C" int GetFleetSize() {
+    InitializeFleet();
+    return (int)fleet.size();
+}
+
+extern "C" void StepFleet(double dtSeconds) {
+    InitializeFleet();
+    if (dtSeconds <= 0.0) return;
+
+    // Scripts act first (they may stop, service or restart machines), then the
+    // environment is computed once and each machine reads its zone while it steps
+    RunBehaviorScripts();
+    UpdateEnvironment(dtSeconds);
+    AdvanceDutyCycles(dtSeconds);
+    for (int i = 0; i < (int)fleet.size(); i++) {
+        machineAmbient = &MachineAmbient(i);
+        StepMachinePhysics(i, dtSeconds);
+        // Stopped machines skip the physics but still sit in their zone's air
+        fleet[i].ambientTemperature = machineAmbient->temperature;
+        fleet[i].humidity = machineAmbient->humidity;
+        fleet[i].ambientPressure = machineAmbient->pressure;
+    }
+    machineAmbient = nullptr;
+    fleetSimTime += dtSeconds;
+    ApplyDutyCycles();
+    ApplyBehaviorOverrides();
+
+    // Process-line coupling sets loads, the electrical model turns them into
+    // torque and speed, rotor dynamics runs at that speed: all three rewrite
+    // channels that the rest consume
+    UpdateProcessLines();
+    UpdateElectricalModel();
+    UpdateRotorDynamics();
+    UpdateOEEAccumulators(dtSeconds);
+    UpdateEnergyAccumulators(dtSeconds);
+    UpdateStateLogs();
+    UpdateStatusBits();
+    UpdateRiskHeaps(dtSeconds);
+    UpdateAnomalyModels();
+    UpdateKalmanFilters(dtSeconds);
+    UpdateThermalRLS(dtSeconds);
+    UpdateForecasters(dtSeconds);
+    UpdateSnapshotFeatures();
+    UpdateMLScores();
+    UpdateVibrationFeatures();
+    UpdateSnapshotHistory();
+    UpdateIsolationScores();
+    UpdateSpectralSignatures();
+    UpdateAcousticChannels();
+    UpdateThermalNetwork(dtSeconds);
+    UpdateHousingGrids(dtSeconds);
+    UpdateElectricalBus();
+}
+
+extern "C" double GetFleetSimulationTime() {
+    return fleetSimTime;
+}
+
+extern "C" void StartMachine(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return;
+    fleet[index].isRunning = true;
+    RefreshMachineStatus(index);
+}
+
+extern "C" void StopMachine(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return;
+    fleet[index].isRunning = false;
+    RefreshMachineStatus(index);
+}
+
+// OEE functions - window: 0=Shift, 1=Day, 2=Week, 3=Lifetime; index -1 = whole fleet
+extern "C" double GetMachineOEE(int index, int window) {
+    InitializeFleet();
+    const OEECounters* c = FindOEECounters(index, window);
+    return c ? OEEScore(*c) : 0.0;
+}
+
+extern "C" double GetMachineAvailability(int index, int window) {
+    InitializeFleet();
+    const OEECounters* c = FindOEECounters(index, window);
+    return c ? OEEAvailability(*c) : 0.0;
+}
+
+extern "C" double GetMachinePerformance(int index, int window) {
+    InitializeFleet();
+    const OEECounters* c = FindOEECounters(index, window);
+    return c ? OEEPerformance(*c) : 0.0;
+}
+
+extern "C" double GetMachineQuality(int index, int window) {
+    InitializeFleet();
+    const OEECounters* c = FindOEECounters(index, window);
+    return c ? OEEQuality(*c) : 0.0;
+}
+
+extern "C" double GetFleetOEE(int window) {
+    return GetMachineOEE(-1, window);
+}
+
+// Energy and tariff functions
+extern "C" void SetTariffFlatRate(double pricePerKWh) {
+    if (!std::isfinite(pricePerKWh)) return;
+    for (int i = 0; i < TARIFF_SLOTS; i++) {
+        tariffPrice[i] = pricePerKWh;
+    }
+    tariffInitialized = true;
+}
+
+// Time-of-use band in hours of day; bands wrap past midnight when end < start
+extern "C" void SetTariffBand(double startHour, double endHour, double pricePerKWh) {
+    InitializeTariff();
+    if (!std::isfinite(startHour) || !std::isfinite(endHour) || !std::isfinite(pricePerKWh)) return;
+    // Hours outside 0-24 (including negative ones) wrap onto the day
+    int first = (int)std::lround(std::fmod(std::fmod(startHour, 24.0) + 24.0, 24.0) * TARIFF_SLOTS_PER_HOUR);
+    int last = (int)std::lround(std::fmod(std::fmod(endHour, 24.0) + 24.0, 24.0) * TARIFF_SLOTS_PER_HOUR);
+    if (last <= first) last += TARIFF_SLOTS;
+    for (int slot = first; slot < last; slot++) {
+        tariffPrice[slot % TARIFF_SLOTS] = pricePerKWh;
+    }
+}
+
+extern "C" void SetDemandCharge(double pricePerKW, double intervalMinutes) {
+    InitializeFleet();
+    demandChargePerKW = std::max(0.0, pricePerKW);
+    if (intervalMinutes > 0.0) {
+        demandIntervalSeconds = intervalMinutes * 60.0;
+    }
+}
+
+extern "C" void ResetEnergyBillingPeriod() {
+    InitializeFleet();
+    ResetEnergyBilling();
+}
+
+extern "C" double GetCurrentTariffPrice() {
+    return TariffPriceAt(fleetSimTime);
+}
+
+extern "C" double GetMachineEnergyKWh(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)machineEnergy.size()) return 0.0;
+    return machineEnergy[index].energyKWh;
+}
+
+extern "C" double GetMachineEnergyCost(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)machineEnergy.size()) return 0.0;
+    return machineEnergy[index].energyCost;
+}
+
+extern "C" double GetMachinePeakDemand(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)machineEnergy.size()) return 0.0;
+    return machineEnergy[index].peakDemandKW;
+}
+
+extern "C" double GetPlantPower() {
+    InitializeFleet();
+    return plantEnergy.powerKW;
+}
+
+extern "C" double GetPlantEnergyKWh() {
+    InitializeFleet();
+    return plantEnergy.energyKWh;
+}
+
+extern "C" double GetPlantEnergyCost() {
+    InitializeFleet();
+    return plantEnergy.energyCost;
+}
+
+extern "C" double GetPlantPeakDemand() {
+    InitializeFleet();
+    return plantEnergy.peakDemandKW;
+}
+
+extern "C" double GetPlantDemandCharge() {
+    InitializeFleet();
+    return plantEnergy.peakDemandKW * demandChargePerKW;
+}
+
+extern "C" double GetPlantTotalCost() {
+    InitializeFleet();
+    return plantEnergy.energyCost + plantEnergy.peakDemandKW * demandChargePerKW;
+}
+
+// Machine state log functions
+// States: 0=Run, 1=Idle, 2=Warning, 3=Critical, 4=Maintenance Due; times in simulated seconds
+extern "C" int GetMachineState(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)machineStateLog.size()) return -1;
+    return machineStateLog[index].intervals.back().state;
+}
+
+extern "C" int GetMachineIntervalCount(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)machineStateLog.size()) return 0;
+    return (int)machineStateLog[index].intervals.size();
+}
+
+extern "C" int GetMachineFailureCount(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)machineStateLog.size()) return 0;
+    return machineStateLog[index].failures;
+}
+
+// Mean time between failures in hours (up time / failures)
+extern "C" double GetMachineMTBF(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)machineStateLog.size()) return 0.0;
+    const MachineStateLog& log = machineStateLog[index];
+    return MachineUptime(log) / std::max(1, log.failures) / 3600.0;
+}
+
+// Mean time to repair in hours (failure onset to return to Run)
+extern "C" double GetMachineMTTR(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)machineStateLog.size()) return 0.0;
+    const MachineStateLog& log = machineStateLog[index];
+    return log.repairs > 0 ? log.repairTime / log.repairs / 3600.0 : 0.0;
+}
+
+extern "C" double GetMachineStateTime(int index, int state, double t0, double t1) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)machineStateLog.size()) return 0.0;
+    if (state < 0 || state >= MACHINE_STATE_COUNT || t1 <= t0) return 0.0;
+    const MachineStateLog& log = machineStateLog[index];
+    return MachineStateTimeUntil(log, state, t1) - MachineStateTimeUntil(log, state, t0);
+}
+
+extern "C" double GetMachineUptime(int index, double t0, double t1) {
+    return GetMachineStateTime(index, MACHINE_STATE_RUN, t0, t1) +
+           GetMachineStateTime(index, MACHINE_STATE_WARNING, t0, t1) +
+           GetMachineStateTime(index, MACHINE_STATE_MAINTENANCE, t0, t1);
+}
+
+// Machines that spent any time in a state during [t0, t1]; returns the count written
+extern "C" int FindMachinesInState(int state, double t0, double t1, int* machines, int maxMachines) {
+    InitializeFleet();
+    if (state < 0 || state >= MACHINE_STATE_COUNT || machines == nullptr || maxMachines <= 0) return 0;
+    const IntervalIndex& index = stateIndex[state];
+    int limit = (int)(std::upper_bound(index.start.begin(), index.start.end(), t1) - index.start.begin());
+    if (limit == 0) return 0;
+
+    stateQueryCounter++;
+    int count = 0;
+    CollectIntervalOverlaps(index, 1, 0, index.capacity, limit, t0, machines, maxMachines, count);
+    return count;
+}
+
+// Range queries reach back this far; INFINITY keeps the full log
+extern "C" int SetStateLogRetention(double hours) {
+    InitializeFleet();
+    if (!(hours > 0.0)) return 0;
+    stateLogRetentionSeconds = hours * 3600.0;
+    return 1;
+}
+
+extern "C" double GetFleetMTBF() {
+    InitializeFleet();
+    double uptime = fleetUptime + fleetOpenUpCount * fleetSimTime - fleetOpenUpStartSum;
+    return uptime / std::max(1, fleetFailures) / 3600.0;
+}
+
+extern "C" double GetFleetMTTR() {
+    InitializeFleet();
+    return fleetRepairs > 0 ? fleetRepairTime / fleetRepairs / 3600.0 : 0.0;
+}
+
+// Fleet status functions
+// Flags: 1=Running, 2=Stopped, 4=Warning, 8=Critical, 16=Maintenance Due (combined with AND)
+extern "C" int CountMachinesWithStatus(int flags) {
+    InitializeFleet();
+    const uint64_t* words = CombineStatusBits(flags);
+    if (words == nullptr) return 0;
+    return (int)PopcountWords(words, statusScratch.size());
+}
+
+extern "C" int FindMachinesWithStatus(int flags, int* machines, int maxMachines) {
+    InitializeFleet();
+    const uint64_t* words = CombineStatusBits(flags);
+    if (words == nullptr || machines == nullptr) return 0;
+
+    int count = 0;
+    for (size_t w = 0; w < statusScratch.size() && count < maxMachines; w++) {
+        uint64_t bits = words[w];
+        while (bits != 0 && count < maxMachines) {
+            machines[count++] = (int)(w * 64 + __builtin_ctzll(bits));
+            bits &= bits - 1;  // Clear lowest set bit
+        }
+    }
+    return count;
+}
+
+extern "C" int GetFleetRunningCount() {
+    return CountMachinesWithStatus(1 << STATUS_RUNNING);
+}
+
+extern "C" int GetFleetWarningCount() {
+    return CountMachinesWithStatus(1 << STATUS_WARNING);
+}
+
+extern "C" int GetFleetCriticalCount() {
+    return CountMachinesWithStatus(1 << STATUS_CRITICAL);
+}
+
+extern "C" int GetFleetMaintenanceDueCount() {
+    return CountMachinesWithStatus(1 << STATUS_MAINTENANCE_DUE);
+}
+
+// At-risk ranking functions - metric: 0=Health, 1=Temperature, 2=Vibration, 3=RUL
+extern "C" int GetTopRiskMachines(int metric, int k, int* machines) {
+    InitializeFleet();
+    if (metric < 0 || metric >= RISK_METRIC_COUNT || machines == nullptr || k <= 0) return 0;
+    return CollectTopRisk(metric, k, machines);
+}
+
+extern "C" double GetMachineRUL(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)machineRUL.size()) return 0.0;
+    return machineRUL[index];
+}
+
+// Multivariate anomaly functions
+// Feature bits: 1=Temperature, 2=VibrationX, 4=VibrationY, 8=VibrationZ, 16=Current, 32=Efficiency, 64=Power
+extern "C" void SetAnomalyFeatures(int featureMask) {
+    InitializeFleet();
+    int mask = featureMask & ANOMALY_ALL_FEATURES;
+    anomalyFeatureMask = mask != 0 ? mask : ANOMALY_ALL_FEATURES;
+    ResizeAnomalyModels((int)fleet.size());
+}
+
+extern "C" void SetAnomalyForgetting(double weight) {
+    anomalyForgetting = std::max(0.0, std::min(0.5, weight));
+}
+
+extern "C" double GetMachineMahalanobisDistance(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return anomalyBlocks[index / ANOMALY_LANES].distance[index % ANOMALY_LANES];
+}
+
+extern "C" int FindAnomalousMachines(double threshold, int* machines, int maxMachines) {
+    InitializeFleet();
+    if (machines == nullptr) return 0;
+    int count = 0;
+    for (int i = 0; i < (int)fleet.size() && count < maxMachines; i++) {
+        if (anomalyBlocks[i / ANOMALY_LANES].distance[i % ANOMALY_LANES] > threshold) {
+            machines[count++] = i;
+        }
+    }
+    return count;
+}
+
+// Kalman state estimate functions
+extern "C" double GetMachineEstimatedTemperature(int index) {
+    InitializeFleet();
+    return KalmanEstimate(index, KF_TEMPERATURE);
+}
+
+extern "C" double GetMachineThermalRate(int index) {
+    InitializeFleet();
+    return KalmanEstimate(index, KF_THERMAL_RATE);
+}
+
+extern "C" double GetMachineEstimatedTorque(int index) {
+    InitializeFleet();
+    return KalmanEstimate(index, KF_TORQUE);
+}
+
+extern "C" double GetMachineEstimatedSpeed(int index) {
+    InitializeFleet();
+    return KalmanEstimate(index, KF_SPEED);
+}
+
+extern "C" double GetMachineEstimatedVibration(int index) {
+    InitializeFleet();
+    return KalmanEstimate(index, KF_VIBRATION);
+}
+
+// Thermal identification functions
+extern "C" void SetThermalRLSForgetting(double lambda) {
+    thermalForgetting = std::max(0.9, std::min(1.0, lambda));
+}
+
+extern "C" double GetMachineThermalResistance(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return MachineThermalTimeConstant(index) / MachineThermalCapacitance(index);
+}
+
+extern "C" double GetMachineThermalCapacitance(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return MachineThermalCapacitance(index);
+}
+
+extern "C" double GetMachineThermalTimeConstant(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return MachineThermalTimeConstant(index);
+}
+
+extern "C" double ForecastMachineTemperature(int index, double horizonSeconds) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return ForecastThermalResponse(index, std::max(0.0, horizonSeconds));
+}
+
+// Channel forecasting functions
+// Channels: 0=Temperature, 1=Vibration, 2=Efficiency, 3=Power, 4=Speed, 5=Current
+extern "C" void SetForecastSmoothing(double alpha, double beta, double gamma) {
+    forecastAlpha = std::max(0.0, std::min(1.0, alpha));
+    forecastBeta = std::max(0.0, std::min(1.0, beta));
+    forecastGamma = std::max(0.0, std::min(1.0, gamma));
+}
+
+extern "C" double ForecastMachineChannel(int index, int channel, double horizonSeconds) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    if (channel < 0 || channel >= FORECAST_CHANNEL_COUNT) return 0.0;
+    return ForecastChannel(index, channel, std::max(0.0, horizonSeconds));
+}
+
+// Native ML inference functions
+extern "C" int GetSnapshotFeatureCount() {
+    return SNAPSHOT_FEATURE_COUNT;
+}
+
+extern "C" int GetMachineSnapshotFeatures(int index, double* features) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || features == nullptr) return 0;
+    const float* row = &fleetSnapshot[(size_t)index * SNAPSHOT_FEATURE_COUNT];
+    for (int f = 0; f < SNAPSHOT_FEATURE_COUNT; f++) features[f] = row[f];
+    return SNAPSHOT_FEATURE_COUNT;
+}
+
+// Load a gbt/mlp model file; returns the model id or -1 on error
+extern "C" int LoadMLModel(const char* path) {
+    InitializeFleet();
+    if (path == nullptr) return -1;
+    std::ifstream in(path);
+    std::string kind;
+    if (!in || !(in >> kind)) return -1;
+
+    MLModel model;
+    bool ok = false;
+    if (kind == "gbt") {
+        model.kind = ML_MODEL_GBT;
+        model.inputs = SNAPSHOT_FEATURE_COUNT;
+        ok = ParseTreeModel(in, model);
+    } else if (kind == "mlp") {
+        model.kind = ML_MODEL_MLP;
+        ok = ParseMLPModel(in, model);
+    }
+    if (!ok) return -1;
+
+    model.fleetScores.assign(fleet.size(), 0.0);
+    mlModels.push_back(std::move(model));
+    ScoreModelBatch(mlModels.back(), fleetSnapshot.data(), (int)fleet.size(), mlModels.back().fleetScores.data());
+    return (int)mlModels.size() - 1;
+}
+
+extern "C" int GetMLModelCount() {
+    return (int)mlModels.size();
 }
 
-extern "C" int GetBoatEngineHours() {
-    UpdateMotorPhysics();
-    return motor.boatEngineHours;
+extern "C" double GetMachineModelScore(int modelId, int index) {
+    InitializeFleet();
+    if (modelId < 0 || modelId >= (int)mlModels.size()) return 0.0;
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return mlModels[modelId].fleetScores[index];
 }
 
-extern "C" double GetBladeSharpness() {
-    UpdateMotorPhysics();
-    return motor.bladeSharpness;
+// Score caller-provided rows of SNAPSHOT_FEATURE_COUNT features; returns rows scored
+extern "C" int ScoreSnapshotBatch(int modelId, const double* features, int rows, double* scores) {
+    if (modelId < 0 || modelId >= (int)mlModels.size()) return 0;
+    if (features == nullptr || scores == nullptr || rows <= 0) return 0;
+
+    // Convert in fixed-size chunks so no per-call allocation is needed
+    const int chunk = 256;
+    float buffer[chunk * SNAPSHOT_FEATURE_COUNT];
+    for (int begin = 0; begin < rows; begin += chunk) {
+        int count = std::min(chunk, rows - begin);
+        for (int i = 0; i < count * SNAPSHOT_FEATURE_COUNT; i++) {
+            buffer[i] = (float)features[(size_t)begin * SNAPSHOT_FEATURE_COUNT + i];
+        }
+        ScoreModelBatch(mlModels[modelId], buffer, count, scores + begin);
+    }
+    return rows;
 }
 
-extern "C" double GetFuelLevel() {
-    UpdateMotorPhysics();
-    return motor.fuelLevel;
+// Vibration condition indicator functions
+// samples: [samplesPerChannel][channels] interleaved; features: [channels][6]
+// (RMS, peak, crest factor, kurtosis, skewness, peak-to-peak)
+extern "C" int ComputeVibrationFeatures(const float* samples, int channels, int samplesPerChannel, double* features) {
+    if (samples == nullptr || features == nullptr || channels <= 0 || samplesPerChannel <= 0) return 0;
+    VibrationFeatures block[VIB_LANES];
+    for (int c0 = 0; c0 < channels; c0 += VIB_LANES) {
+        int width = std::min(VIB_LANES, channels - c0);
+        ComputeVibrationFeatureBlock(samples + c0, channels, width, samplesPerChannel, block);
+        for (int l = 0; l < width; l++) {
+            for (int f = 0; f < VIB_FEATURE_COUNT; f++) {
+                features[(size_t)(c0 + l) * VIB_FEATURE_COUNT + f] = block[l].values[f];
+            }
+        }
+    }
+    return channels;
 }
 
-extern "C" double GetGeneratorPowerOutput() {
-    UpdateMotorPhysics();
-    return motor.generatorPowerOutput;
+extern "C" void SetVibrationWindowSamples(int samples) {
+    if (samples < 16) return;
+    vibrationWindow = samples;
+    AllocateVibrationBuffers();
 }
 
-extern "C" double GetGeneratorFuelEfficiency() {
-    UpdateMotorPhysics();
-    return motor.generatorFuelEfficiency;
+// Vibration windows, condition indicators and spectral signatures are only
+// produced for machines with analysis enabled (off by default)
+extern "C" int EnableVibrationAnalysis(int index, int enabled) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0;
+    SetVibrationAnalysis(index, enabled != 0);
+    if (!enabled) machineSpectra[index] = SpectralSignature{};
+    return 1;
 }
 
-extern "C" double GetPoolPumpFlowRate() {
-    UpdateMotorPhysics();
-    return motor.poolPumpFlowRate;
+extern "C" int IsVibrationAnalysisEnabled(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0;
+    return vibrationSlot[index] >= 0 ? 1 : 0;
 }
 
-extern "C" double GetPoolPumpEnergyUsage() {
-    UpdateMotorPhysics();
-    return motor.poolPumpEnergyUsage;
+// axis: 0=X, 1=Y, 2=Z; feature: 0=RMS, 1=Peak, 2=Crest, 3=Kurtosis, 4=Skewness, 5=Peak-to-Peak
+extern "C" double GetMachineVibrationFeature(int index, int axis, int feature) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    if (axis < 0 || axis >= VIB_AXES || feature < 0 || feature >= VIB_FEATURE_COUNT) return 0.0;
+    int slot = vibrationSlot[index];
+    if (slot < 0) return 0.0;
+    return vibrationFeatures[(size_t)slot * VIB_AXES + axis].values[feature];
 }
 
-extern "C" double GetWashingMachineEfficiency() {
-    UpdateMotorPhysics();
-    return motor.washingMachineEfficiency;
+// Snapshot history and isolation forest functions
+// Steps of history to keep (0 disables recording); returns 1, or 0 for a negative count
+extern "C" int SetSnapshotHistoryCapacity(int steps) {
+    if (steps < 0) return 0;
+    historyCapacity = steps;
+    ResetSnapshotHistory();
+    return 1;
 }
 
-extern "C" double GetDishwasherEfficiency() {
-    UpdateMotorPhysics();
-    return motor.dishwasherEfficiency;
+extern "C" int GetSnapshotHistoryLength() {
+    return historyLength;
 }
 
-extern "C" double GetRefrigeratorEfficiency() {
-    UpdateMotorPhysics();
-    return motor.refrigeratorEfficiency;
+// Train on running-machine rows from the snapshot history; returns 1 on success
+extern "C" int TrainIsolationForest(int trees, int sampleSize) {
+    InitializeFleet();
+    if (trees <= 0) trees = DEFAULT_ISOLATION_TREES;
+    if (sampleSize <= 1) sampleSize = DEFAULT_ISOLATION_SAMPLE;
+    if (!TrainIsolationForestFromHistory(trees, sampleSize)) return 0;
+    UpdateIsolationScores();
+    return 1;
 }
 
-extern "C" double GetAirConditionerEfficiency() {
-    UpdateMotorPhysics();
-    return motor.airConditionerEfficiency;
+extern "C" double GetMachineIsolationScore(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return isolationScores[index];
 }
 
-// Industrial Machine Functions
-extern "C" int GetIndustrialMachineCount() {
-    UpdateMotorPhysics();
-    return motor.machineCount;
+// Score caller-provided rows of SNAPSHOT_FEATURE_COUNT features; returns rows scored
+extern "C" int ScoreIsolationBatch(const double* features, int rows, double* scores) {
+    if (isolationRoots.empty() || features == nullptr || scores == nullptr || rows <= 0) return 0;
+    const int chunk = 256;
+    float buffer[chunk * SNAPSHOT_FEATURE_COUNT];
+    for (int begin = 0; begin < rows; begin += chunk) {
+        int count = std::min(chunk, rows - begin);
+        for (int i = 0; i < count * SNAPSHOT_FEATURE_COUNT; i++) {
+            buffer[i] = (float)features[(size_t)begin * SNAPSHOT_FEATURE_COUNT + i];
+        }
+        ScoreIsolationRows(buffer, count, scores + begin);
+    }
+    return rows;
 }
 
-extern "C" bool GetMachineRunning(int index) {
-    UpdateMotorPhysics();
-    return motor.isRunning;
+extern "C" int FindIsolationAnomalies(double threshold, int* machines, int maxMachines) {
+    InitializeFleet();
+    if (machines == nullptr || isolationRoots.empty()) return 0;
+    int count = 0;
+    for (int i = 0; i < (int)fleet.size() && count < maxMachines; i++) {
+        if (isolationScores[i] > threshold) {
+            machines[count++] = i;
+        }
+    }
+    return count;
 }
 
-extern "C" double GetMachineLoad(int index) {
-    UpdateMotorPhysics();
-    return motor.load;
+// Matrix profile functions
+// profile/profileIndex may be null; results are kept for motif/discord queries
+extern "C" int ComputeMatrixProfile(const double* series, int length, int window, double* profile, int* profileIndex) {
+    int count = RunMatrixProfile(series, length, window);
+    for (int i = 0; i < count; i++) {
+        if (profile != nullptr) profile[i] = matrixProfile[i];
+        if (profileIndex != nullptr) profileIndex[i] = matrixProfileIndex[i];
+    }
+    return count;
 }
 
-// Motor control functions
-extern "C" void StartMotor() {
-    UpdateMotorPhysics();
-    motor.isRunning = true;
+// Profile one snapshot feature of a machine over the recorded history
+extern "C" int ComputeMachineMatrixProfile(int index, int feature, int window) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || feature < 0 || feature >= SNAPSHOT_FEATURE_COUNT) return 0;
+    std::vector<double> series(historyLength);
+    for (int age = 0; age < historyLength; age++) {
+        series[age] = HistoryRow(age, index)[feature];
+    }
+    return RunMatrixProfile(series.data(), historyLength, window);
 }
 
-extern "C" void StopMotor() {
-    UpdateMotorPhysics();
-    motor.isRunning = false;
+// Top-k motif pairs (lowest profile values); returns pairs written
+extern "C" int GetMatrixProfileMotifs(int k, int* positions, int* neighbors, double* distances) {
+    if (positions == nullptr || neighbors == nullptr || k <= 0) return 0;
+    return SelectMatrixProfileExtremes(false, k, positions, neighbors, distances);
 }
 
-extern "C" void ResetMotorState() {
-    InitializeMotor();
+// Top-k discords (highest profile values); returns positions written
+extern "C" int GetMatrixProfileDiscords(int k, int* positions, double* distances) {
+    if (positions == nullptr || k <= 0) return 0;
+    return SelectMatrixProfileExtremes(true, k, positions, nullptr, distances);
 }
 
-// Reset physics update flag - call this after reading all values for one sample
-extern "C" void ResetPhysicsUpdateFlag() {
-    physicsUpdatedThisReading = false;
+// Change-point detection functions
+// method: 0=PELT, 1=Binary segmentation; costModel: 0=Mean shift, 1=Mean and variance shift
+// penalty <= 0 selects BIC; output arrays may be null; returns segments written
+extern "C" int DetectChangePoints(const double* series, int length, int method, int costModel, double penalty, int minSegment,
+                                  int* starts, int* ends, double* means, double* stdDevs, int maxSegments) {
+    if (series == nullptr || length <= 0 || maxSegments <= 0) return 0;
+    if (minSegment <= 0) minSegment = DEFAULT_MIN_SEGMENT;
+    std::vector<ChangeSegment> segments;
+    SegmentSeries(series, length, method, costModel, penalty, minSegment, segments);
+    return CopySegments(segments, starts, ends, means, stdDevs, maxSegments);
+}
+
+// Segment one snapshot feature of every machine's recorded history (in parallel)
+extern "C" int DetectFleetChangePoints(int feature, int method, int costModel, double penalty, int minSegment) {
+    InitializeFleet();
+    if (feature < 0 || feature >= SNAPSHOT_FEATURE_COUNT) return 0;
+    if (minSegment <= 0) minSegment = DEFAULT_MIN_SEGMENT;
+    SegmentFleetHistory(feature, method, costModel, penalty, minSegment);
+    return (int)fleet.size();
+}
+
+// Segments from the last fleet run; positions are history steps (0 = oldest)
+extern "C" int GetMachineSegments(int index, int* starts, int* ends, double* means, double* stdDevs, int maxSegments) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)machineSegments.size() || maxSegments <= 0) return 0;
+    return CopySegments(machineSegments[index], starts, ends, means, stdDevs, maxSegments);
+}
+
+// Spectral signature search functions
+extern "C" int GetSpectralBandCount() {
+    return SPECTRAL_BANDS;
+}
+
+extern "C" void SetSpectralHistoryCapacity(int entries) {
+    if (entries < 1) return;
+    spectralCapacity = entries;
+    if (!fleet.empty()) ResizeSpectralSignatures((int)fleet.size());
+}
+
+extern "C" int GetSpectralEntryCount() {
+    return (int)std::min<uint64_t>(spectralInserted, spectralCapacity);
+}
+
+// Latest unit-length band amplitude vector; returns bands written (0 while stopped)
+extern "C" int GetMachineSpectralSignature(int index, double* bands) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || bands == nullptr) return 0;
+    if (!fleet[index].isRunning) return 0;
+    for (int b = 0; b < SPECTRAL_BANDS; b++) bands[b] = machineSpectra[index].bands[b];
+    return SPECTRAL_BANDS;
+}
+
+// Train the IVF coarse lists on the stored signatures; returns the list count
+extern "C" int BuildSpectralIndex(int lists, int iterations) {
+    InitializeFleet();
+    if (spectralInserted == 0 || lists <= 0) return 0;
+    BuildSpectralLists(lists, std::max(1, iterations));
+    return (int)spectralCentroids.size();
+}
+
+// nprobe <= 0 (or no index built) scans every stored signature; returns matches written
+extern "C" int FindSimilarSpectra(const double* bands, int k, int nprobe, int* machines, double* times, double* similarities) {
+    InitializeFleet();
+    if (bands == nullptr || k <= 0) return 0;
+    SpectralSignature query;
+    for (int b = 0; b < SPECTRAL_BANDS; b++) query.bands[b] = (float)bands[b];
+    NormalizeSignature(query);
+    std::vector<std::pair<float, int>> best;
+    SearchSpectralSignatures(query, k, nprobe, -1, 0.0, best);
+    return CopySpectralMatches(best, machines, times, similarities);
+}
+
+// Matches for a machine's latest spectrum, excluding that entry itself
+extern "C" int FindSimilarToMachine(int index, int k, int nprobe, int* machines, double* times, double* similarities) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || k <= 0 || !fleet[index].isRunning || vibrationSlot[index] < 0) return 0;
+    std::vector<std::pair<float, int>> best;
+    SearchSpectralSignatures(machineSpectra[index], k, nprobe, index, fleetSimTime, best);
+    return CopySpectralMatches(best, machines, times, similarities);
+}
+
+// Acoustic filter bank functions
+// thirdOctave: 1 = 27 bands 25 Hz - 10 kHz, 0 = 9 octave bands 31.5 Hz - 8 kHz
+extern "C" void SetAcousticBandMode(int thirdOctave) {
+    acousticThirdOctave = thirdOctave != 0;
+    ResetAcousticChannels();
+}
+
+// Samples analyzed per machine per step; 0 disables acoustic analysis
+extern "C" void SetAcousticBlockSamples(int samples) {
+    if (samples < 0) return;
+    acousticBlock = samples;
+    acousticBuffer.assign(acousticBlock, 0.0f);
+}
+
+// Sound synthesis and filtering are only run for machines with acoustic
+// analysis enabled (off by default)
+extern "C" int EnableAcousticAnalysis(int index, int enabled) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0;
+    SetAcousticAnalysis(index, enabled != 0);
+    return 1;
+}
+
+extern "C" int IsAcousticAnalysisEnabled(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0;
+    return acousticSlot[index] >= 0 ? 1 : 0;
+}
+
+// Band centre frequencies; returns band count
+extern "C" int GetAcousticBandCenters(double* centers) {
+    InitializeFleet();
+    if (centers != nullptr) {
+        for (int b = 0; b < acousticBands; b++) centers[b] = acousticCenters[b];
+    }
+    return acousticBands;
+}
+
+// weighted: 1 = LAeq (dBA), 0 = unweighted Leq (dB)
+extern "C" double GetMachineAcousticLevel(int index, int weighted) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || acousticSlot[index] < 0) return 0.0;
+    const AcousticChannel& channel = acousticChannels[acousticSlot[index]];
+    return weighted ? channel.weightedLevel : channel.unweightedLevel;
+}
+
+extern "C" int GetMachineBandLevels(int index, double* levels) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || levels == nullptr || acousticSlot[index] < 0) return 0;
+    for (int b = 0; b < acousticBands; b++) levels[b] = acousticChannels[acousticSlot[index]].bandLevel[b];
+    return acousticBands;
+}
+
+// Analyze a recorded pressure signal (Pa at 48 kHz) from rest; returns band count
+extern "C" int AnalyzeAcousticSignal(const float* samples, int count, double* bandLevels, double* weightedLevel) {
+    InitializeFleet();
+    if (samples == nullptr || count <= 0) return 0;
+    AcousticChannel channel;
+    ResetAcousticChannel(channel);
+    AnalyzeAcousticBlock(channel, samples, count);
+    if (bandLevels != nullptr) {
+        for (int b = 0; b < acousticBands; b++) bandLevels[b] = channel.bandLevel[b];
+    }
+    if (weightedLevel != nullptr) *weightedLevel = channel.weightedLevel;
+    return acousticBands;
+}
+
+// Thermal network functions
+// node: 0=Winding, 1=Stator Core, 2=Rotor, 3=Bearing DE, 4=Bearing NDE, 5=Housing
+extern "C" int GetThermalNodeCount() {
+    return TN_NODES;
+}
+
+extern "C" double GetMachineNodeTemperature(int index, int node) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || node < 0 || node >= TN_NODES) return 0.0;
+    return tnTemperature[node][index];
+}
+
+// Hottest node temperature; the node id is written to hotNode when given
+extern "C" double GetMachineHotSpotTemperature(int index, int* hotNode) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    int hottest = 0;
+    for (int a = 1; a < TN_NODES; a++) {
+        if (tnTemperature[a][index] > tnTemperature[hottest][index]) hottest = a;
+    }
+    if (hotNode != nullptr) *hotNode = hottest;
+    return tnTemperature[hottest][index];
+}
+
+// Node-to-node conductance (W/K); a == b sets the node's conductance to ambient
+extern "C" int SetThermalConductance(int nodeA, int nodeB, double conductance) {
+    if (nodeA < 0 || nodeA >= TN_NODES || nodeB < 0 || nodeB >= TN_NODES || conductance < 0.0) return 0;
+    if (thermalNetwork.capacity[0] == 0.0) SetDefaultThermalNetwork();
+    if (nodeA == nodeB) {
+        thermalNetwork.ambientConductance[nodeA] = conductance;
+    } else {
+        thermalNetwork.conductance[nodeA][nodeB] = thermalNetwork.conductance[nodeB][nodeA] = conductance;
+    }
+    thermalNetwork.factoredDt = 0.0;
+    return 1;
+}
+
+extern "C" int SetThermalCapacity(int node, double capacity) {
+    if (node < 0 || node >= TN_NODES || capacity <= 0.0) return 0;
+    if (thermalNetwork.capacity[0] == 0.0) SetDefaultThermalNetwork();
+    thermalNetwork.capacity[node] = capacity;
+    thermalNetwork.factoredDt = 0.0;
+    housingSweep.substep = 0.0;  // The grid's convection rate derives from the housing capacity
+    return 1;
+}
+
+// Housing thermal grid functions
+// Enabling starts the grid at the machine's housing node temperature
+extern "C" int EnableHousingGrid(int index, int enabled) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0;
+    if (!enabled) {
+        housingGrids[index].clear();
+        housingGrids[index].shrink_to_fit();
+    } else if (housingGrids[index].empty()) {
+        housingGrids[index].assign(HG_NX * HG_NY, tnTemperature[TN_HOUSING][index]);
+    }
+    return 1;
+}
+
+extern "C" int GetHousingGridWidth() {
+    return HG_NX;
+}
+
+extern "C" int GetHousingGridHeight() {
+    return HG_NY;
+}
+
+// Box-downsampled heatmap, row-major [height][width] with row 0 at the drive end
+extern "C" int GetMachineHousingHeatmap(int index, int width, int height, double* heatmap) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || housingGrids[index].empty() || heatmap == nullptr) return 0;
+    if (width <= 0 || width > HG_NX || height <= 0 || height > HG_NY) return 0;
+    const std::vector<double>& grid = housingGrids[index];
+    for (int r = 0; r < height; r++) {
+        int y0 = r * HG_NY / height, y1 = (r + 1) * HG_NY / height;
+        for (int c = 0; c < width; c++) {
+            int x0 = c * HG_NX / width, x1 = (c + 1) * HG_NX / width;
+            double sum = 0.0;
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) sum += grid[(size_t)y * HG_NX + x];
+            }
+            heatmap[r * width + c] = sum / ((y1 - y0) * (x1 - x0));
+        }
+    }
+    return width * height;
+}
+
+extern "C" double GetMachineHousingMaxTemperature(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || housingGrids[index].empty()) return 0.0;
+    return *std::max_element(housingGrids[index].begin(), housingGrids[index].end());
+}
+
+// Rotor dynamics functions
+// axis: 0=X, 1=Y (bearing journal), 2=Z (axial); mm/s RMS over the last window
+extern "C" double GetMachineRotorVibration(int index, int axis) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || axis < 0 || axis > 2) return 0.0;
+    return rotor.velocityRms[axis][index];
+}
+
+// Shaft (disk) displacement peak-to-peak over the last window, mm
+extern "C" double GetMachineShaftDisplacement(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return rotor.displacementPP[index];
+}
+
+// Most recent disk positions (micrometres), oldest first; returns points written
+extern "C" int GetMachineShaftOrbit(int index, double* x, double* y, int maxPoints) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || x == nullptr || y == nullptr || maxPoints <= 0) return 0;
+    int slot = rotorSlot[index];
+    if (slot < 0) return 0;
+    int points = std::min(maxPoints, ROTOR_ORBIT_SAMPLES);
+    const float* orbitX = &rotor.orbitX[(size_t)slot * ROTOR_ORBIT_SAMPLES + ROTOR_ORBIT_SAMPLES - points];
+    const float* orbitY = &rotor.orbitY[(size_t)slot * ROTOR_ORBIT_SAMPLES + ROTOR_ORBIT_SAMPLES - points];
+    for (int p = 0; p < points; p++) {
+        x[p] = 1e6 * orbitX[p];
+        y[p] = 1e6 * orbitY[p];
+    }
+    return points;
+}
+
+// Coupling offset in micrometres
+extern "C" int SetMachineMisalignment(int index, double micrometres) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || micrometres < 0.0) return 0;
+    rotor.misalignment[index] = micrometres * 1e-6;
+    return 1;
+}
+
+// enabled: rotor outputs replace fleet vibration/displacement/shaftPosition channels
+extern "C" void SetRotorDynamicsDrivesSensors(int enabled) {
+    rotorDrivesSensors = enabled != 0;
+}
+
+// The Jeffcott rotor is only integrated for machines with rotor dynamics
+// enabled (off by default; index -1 selects the whole fleet). A disabled
+// rotor is reset to rest, its orbit is released and its outputs read 0
+extern "C" int EnableRotorDynamics(int index, int enabled) {
+    InitializeFleet();
+    if (index < -1 || index >= (int)fleet.size()) return 0;
+    int first = index < 0 ? 0 : index, last = index < 0 ? (int)fleet.size() : index + 1;
+    for (int i = first; i < last; i++) {
+        SetRotorDynamics(i, enabled != 0);
+    }
+    return 1;
+}
+
+extern "C" int IsRotorDynamicsEnabled(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0;
+    return rotorSlot[index] >= 0 ? 1 : 0;
+}
+
+// Induction machine electrical model functions
+// Integration rate, 10-20 kHz
+extern "C" int SetElectricalSampleRate(double hz) {
+    if (hz < 10000.0 || hz > 20000.0) return 0;
+    electricalSampleRate = hz;
+    return 1;
+}
+
+extern "C" int SetDriveRampRate(double hzPerSecond) {
+    if (hzPerSecond <= 0.0) return 0;
+    driveRampRate = hzPerSecond;
+    return 1;
+}
+
+// Drive output frequency, Hz
+extern "C" double GetMachineSupplyFrequency(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return electrical.frequency[index];
+}
+
+extern "C" double GetMachineSlip(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return electrical.slip[index];
+}
+
+// Rotor flux linkage magnitude, Wb
+extern "C" double GetMachineRotorFlux(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return electrical.rotorFlux[index];
+}
+
+// Electromagnetic torque, N*m
+extern "C" double GetMachineElectromagneticTorque(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return electrical.torque[index];
+}
+
+// enabled: model outputs replace fleet speed/torque/voltage/current/powerFactor/powerConsumption
+extern "C" void SetElectricalModelDrivesSensors(int enabled) {
+    electricalDrivesSensors = enabled != 0;
+}
+
+// The dq model is only integrated for machines with it enabled (off by
+// default; index -1 selects the whole fleet). A disabled machine is
+// de-energized and ramps up from standstill when enabled again
+extern "C" int EnableElectricalModel(int index, int enabled) {
+    InitializeFleet();
+    if (index < -1 || index >= (int)fleet.size()) return 0;
+    int first = index < 0 ? 0 : index, last = index < 0 ? (int)fleet.size() : index + 1;
+    for (int i = first; i < last; i++) {
+        SetElectricalModel(i, enabled != 0);
+    }
+    return 1;
+}
+
+extern "C" int IsElectricalModelEnabled(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0;
+    return electricalSlot[index] >= 0 ? 1 : 0;
+}
+
+// Plant electrical bus functions
+// Rebuilds the topology and spreads machines round-robin; returns feeder count
+extern "C" int ConfigureElectricalBus(int transformers, int feedersPerTransformer) {
+    InitializeFleet();
+    if (transformers <= 0 || feedersPerTransformer <= 0) return 0;
+    ConfigureBusTopology(transformers, feedersPerTransformer);
+    return (int)busFeeders.size();
+}
+
+extern "C" int AssignMachineFeeder(int index, int feeder) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || feeder < 0 || feeder >= (int)busFeeders.size()) return 0;
+    machineFeeder[index] = feeder;
+    return 1;
+}
+
+extern "C" int SetTransformerRating(int transformer, double kVA, double impedancePercent) {
+    InitializeFleet();
+    if (transformer < 0 || transformer >= (int)busTransformers.size() || kVA <= 0.0 || impedancePercent <= 0.0) return 0;
+    busTransformers[transformer].ratingKVA = kVA;
+    busTransformers[transformer].impedancePercent = impedancePercent;
+    return 1;
+}
+
+// Cable impedance per phase, Ohm
+extern "C" int SetFeederImpedance(int feeder, double resistance, double reactance) {
+    InitializeFleet();
+    if (feeder < 0 || feeder >= (int)busFeeders.size() || resistance < 0.0 || reactance < 0.0) return 0;
+    busFeeders[feeder].resistance = resistance;
+    busFeeders[feeder].reactance = reactance;
+    return 1;
+}
+
+// Apparent load as % of rating (RMS current including harmonics)
+extern "C" double GetTransformerLoading(int transformer) {
+    InitializeFleet();
+    if (transformer < 0 || transformer >= (int)busTransformers.size()) return 0.0;
+    return busTransformers[transformer].loadingPercent;
+}
+
+extern "C" double GetTransformerKFactor(int transformer) {
+    InitializeFleet();
+    if (transformer < 0 || transformer >= (int)busTransformers.size()) return 0.0;
+    return busTransformers[transformer].kFactor;
+}
+
+// Fundamental voltage drop, % of nominal
+extern "C" double GetTransformerVoltageDrop(int transformer) {
+    InitializeFleet();
+    if (transformer < 0 || transformer >= (int)busTransformers.size()) return 0.0;
+    return busTransformers[transformer].voltageDropPercent;
+}
+
+extern "C" double GetTransformerVoltageTHD(int transformer) {
+    InitializeFleet();
+    if (transformer < 0 || transformer >= (int)busTransformers.size()) return 0.0;
+    return busTransformers[transformer].voltageThdPercent;
+}
+
+// RMS current per phase including harmonics, A
+extern "C" double GetFeederCurrent(int feeder) {
+    InitializeFleet();
+    if (feeder < 0 || feeder >= (int)busFeeders.size()) return 0.0;
+    return busFeeders[feeder].currentRms;
+}
+
+// Voltage drop at the feeder end (transformer plus cable), % of nominal
+extern "C" double GetFeederVoltageDrop(int feeder) {
+    InitializeFleet();
+    if (feeder < 0 || feeder >= (int)busFeeders.size()) return 0.0;
+    return busFeeders[feeder].voltageDropPercent;
+}
+
+// Writes orders and RMS magnitudes (A) of fundamental and harmonics; returns count
+extern "C" int GetFeederHarmonicCurrents(int feeder, int* orders, double* magnitudes, int maxHarmonics) {
+    InitializeFleet();
+    if (feeder < 0 || feeder >= (int)busFeeders.size() || maxHarmonics <= 0) return 0;
+    int harmonics = std::min(maxHarmonics, BUS_HARMONICS);
+    for (int h = 0; h < harmonics; h++) {
+        if (orders != nullptr) orders[h] = BUS_HARMONIC_ORDER[h];
+        if (magnitudes != nullptr) magnitudes[h] = std::abs(busFeeders[feeder].current[h]);
+    }
+    return harmonics;
+}
+
+// trueFactor: 0 = displacement power factor, 1 = true power factor (with distortion)
+extern "C" double GetPlantPowerFactor(int trueFactor) {
+    InitializeFleet();
+    return trueFactor ? plantBus.truePowerFactor : plantBus.displacementPowerFactor;
+}
+
+extern "C" double GetPlantReactivePower() {
+    InitializeFleet();
+    return plantBus.reactiveKVAR;
+}
+
+extern "C" double GetPlantCurrentTHD() {
+    InitializeFleet();
+    return plantBus.currentThdPercent;
+}
+
+// Process line functions
+// share: fraction of the upstream machine's throughput fed downstream.
+// Returns 0 for invalid machines or an edge that would close a cycle.
+extern "C" int AddProcessEdge(int upstream, int downstream, double share) {
+    InitializeFleet();
+    int count = (int)fleet.size();
+    if (upstream < 0 || upstream >= count || downstream < 0 || downstream >= count || share <= 0.0) return 0;
+    if (upstream == downstream || ProcessReachable(downstream, upstream)) return 0;
+    processGraph.edges.push_back({ upstream, downstream, share });
+    processGraph.downstream[upstream].push_back(downstream);
+    processGraph.compiled = false;
+    return 1;
+}
+
+extern "C" void ClearProcessEdges() {
+    InitializeFleet();
+    ResizeProcessLines((int)fleet.size());
+}
+
+// 0 = machines independent, 1 = dependent machines run entirely on supply
+extern "C" int SetProcessCoupling(double coupling) {
+    if (coupling < 0.0 || coupling > 1.0) return 0;
+    processCoupling = coupling;
+    return 1;
+}
+
+extern "C" int GetProcessLevelCount() {
+    InitializeFleet();
+    return ProcessLevelCount();
+}
+
+extern "C" int GetMachineProcessLevel(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return -1;
+    ProcessLevelCount();
+    return processGraph.edges.empty() ? 0 : processGraph.level[index];
+}
+
+// Load actually delivered downstream last step (0 when stopped)
+extern "C" double GetMachineThroughput(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return 0.0;
+    return machineThroughput[index];
+}
+
+// Plant environment functions
+// Calendar position of simulated time 0 (dayOfYear 1-365, hour 0-24); tariff
+// bands, forecast seasons and shift scripts follow the same plant clock
+extern "C" int SetEnvironmentClock(int dayOfYear, double hourOfDay) {
+    if (dayOfYear < 1 || dayOfYear > 365 || hourOfDay < 0.0 || hourOfDay >= 24.0) return 0;
+    plantStartDay = dayOfYear;
+    plantStartHour = hourOfDay;
+    UpdateEnvironment(0.0);
+    return 1;
+}
+
+// Outdoor climate: annual mean °C, seasonal and daily half-swings °C, mean RH %
+extern "C" int SetSiteClimate(double annualMean, double annualAmplitude, double dailyAmplitude, double meanHumidity) {
+    if (annualAmplitude < 0.0 || dailyAmplitude < 0.0 || meanHumidity < 0.0 || meanHumidity > 100.0) return 0;
+    siteClimate.annualMean = annualMean;
+    siteClimate.annualAmplitude = annualAmplitude;
+    siteClimate.dailyAmplitude = dailyAmplitude;
+    siteClimate.meanHumidity = meanHumidity;
+    UpdateEnvironment(0.0);
+    return 1;
+}
+
+// Returns the new zone index, or -1 for invalid parameters
+extern "C" int AddPlantZone(double outdoorCoupling, double setpoint, double heatGain) {
+    InitializeFleet();
+    if (outdoorCoupling < 0.0 || outdoorCoupling > 1.0) return -1;
+    plantZones.push_back({ outdoorCoupling, setpoint, heatGain, AmbientConditions() });
+    ComputeZoneConditions(plantZones.back());
+    return (int)plantZones.size() - 1;
+}
+
+extern "C" int SetPlantZone(int zone, double outdoorCoupling, double setpoint, double heatGain) {
+    InitializeFleet();
+    if (zone < 0 || zone >= (int)plantZones.size() || outdoorCoupling < 0.0 || outdoorCoupling > 1.0) return 0;
+    plantZones[zone].outdoorCoupling = outdoorCoupling;
+    plantZones[zone].setpoint = setpoint;
+    plantZones[zone].heatGain = heatGain;
+    ComputeZoneConditions(plantZones[zone]);
+    return 1;
+}
+
+extern "C" int AssignMachineZone(int index, int zone) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || zone < 0 || zone >= (int)plantZones.size()) return 0;
+    machineZone[index] = zone;
+    return 1;
+}
+
+extern "C" int GetMachineZone(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size()) return -1;
+    return machineZone[index];
+}
+
+extern "C" int GetPlantZoneCount() {
+    InitializeFleet();
+    return (int)plantZones.size();
+}
+
+extern "C" double GetZoneTemperature(int zone) {
+    InitializeFleet();
+    if (zone < 0 || zone >= (int)plantZones.size()) return 0.0;
+    return plantZones[zone].conditions.temperature;
+}
+
+extern "C" double GetZoneHumidity(int zone) {
+    InitializeFleet();
+    if (zone < 0 || zone >= (int)plantZones.size()) return 0.0;
+    return plantZones[zone].conditions.humidity;
+}
+
+extern "C" double GetOutdoorTemperature() {
+    InitializeFleet();
+    return outdoorConditions.temperature;
+}
+
+extern "C" double GetOutdoorHumidity() {
+    InitializeFleet();
+    return outdoorConditions.humidity;
+}
+
+// kPa, shared by all zones
+extern "C" double GetPlantAmbientPressure() {
+    InitializeFleet();
+    return outdoorConditions.pressure;
+}
+
+// Duty-cycle functions
+// dutyType 1-10 (S1-S10); dutyFactor = on-time share; load = rated-load fraction.
+// Returns the profile index, or -1 for invalid parameters.
+extern "C" int CreateStandardDutyProfile(int dutyType, double periodSeconds, double dutyFactor, double load) {
+    // Negated comparisons so NaN fails them too
+    if (dutyType < DUTY_S1 || dutyType > DUTY_S10 || !(periodSeconds > 0.0) || !std::isfinite(periodSeconds)) return -1;
+    if (!(dutyFactor >= 0.0 && dutyFactor <= 1.0) || !(load >= 0.0 && load <= 1.0)) return -1;
+    std::vector<DutySegment> segments = StandardDutySegments(dutyType, periodSeconds, dutyFactor, load);
+    if (segments.empty()) return -1;
+    return CompileDutyProfile(segments);
+}
+
+// Custom piecewise profile; running[k] = 0 marks rest segments. Durations must
+// be finite and positive, loads within 0-1 and speed factors finite and
+// non-negative. Returns the profile index or -1.
+extern "C" int CreateDutyProfile(const double* durations, const double* loadStart, const double* loadEnd,
+                                 const double* speedStart, const double* speedEnd, const int* running, int segments) {
+    if (durations == nullptr || loadStart == nullptr || loadEnd == nullptr || speedStart == nullptr ||
+        speedEnd == nullptr || running == nullptr || segments <= 0) return -1;
+    std::vector<DutySegment> list(segments);
+    for (int k = 0; k < segments; k++) {
+        if (!(durations[k] > 0.0) || !std::isfinite(durations[k])) return -1;
+        if (!(loadStart[k] >= 0.0 && loadStart[k] <= 1.0) || !(loadEnd[k] >= 0.0 && loadEnd[k] <= 1.0)) return -1;
+        if (!(speedStart[k] >= 0.0) || !std::isfinite(speedStart[k])) return -1;
+        if (!(speedEnd[k] >= 0.0) || !std::isfinite(speedEnd[k])) return -1;
+        list[k] = { durations[k], loadStart[k], loadEnd[k], speedStart[k], speedEnd[k], running[k] != 0 };
+    }
+    return CompileDutyProfile(list);
+}
+
+// profile -1 removes the schedule; phaseSeconds offsets the machine within the period
+extern "C" int AssignMachineDutyProfile(int index, int profile, double phaseSeconds) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || profile < -1 || profile >= (int)duty.profileFirst.size()) return 0;
+    if (!std::isfinite(phaseSeconds)) return 0;
+    machineDutyProfile[index] = profile;
+    if (profile < 0) return 1;
+    machineDutySegment[index] = duty.profileFirst[profile];
+    machineDutyElapsed[index] = 0.0;
+    AdvanceDutyCursor(machineDutySegment[index], machineDutyElapsed[index], profile,
+                      std::fmod(std::fmod(phaseSeconds, duty.period[profile]) + duty.period[profile], duty.period[profile]));
+    fleet[index].isRunning = duty.running[machineDutySegment[index]] != 0;
+    return 1;
+}
+
+extern "C" int GetDutyProfileCount() {
+    return (int)duty.profileFirst.size();
+}
+
+extern "C" double GetDutyProfilePeriod(int profile) {
+    if (profile < 0 || profile >= (int)duty.profileFirst.size()) return 0.0;
+    return duty.period[profile];
+}
+
+// Segment index within the machine's profile, or -1 when unscheduled
+extern "C" int GetMachineDutySegment(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || machineDutyProfile[index] < 0) return -1;
+    return machineDutySegment[index] - duty.profileFirst[machineDutyProfile[index]];
+}
+
+// Scheduled load at the current cursor (0 in rest segments), or -1 when unscheduled
+extern "C" double GetMachineDutyLoad(int index) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || machineDutyProfile[index] < 0) return -1.0;
+    return duty.running[machineDutySegment[index]] ? MachineDutyLoad(index) : 0.0;
+}
+
+// Behavior script functions
+// Stops the machine, keeps it down for downtimeSeconds, resets oil condition,
+// restarts and ramps speed back up over rampSeconds. Returns the script id or -1.
+extern "C" int StartMaintenanceScript(int index, double downtimeSeconds, double rampSeconds) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || downtimeSeconds < 0.0 || rampSeconds < 0.0) return -1;
+    return LaunchScript(MaintenanceScript(index, downtimeSeconds, rampSeconds));
+}
+
+// Runs the machine for shiftHours from startHour each day (plant clock). Returns the script id or -1.
+extern "C" int StartShiftScript(int index, double startHour, double shiftHours) {
+    InitializeFleet();
+    if (index < 0 || index >= (int)fleet.size() || startHour < 0.0 || startHour >= 24.0) return -1;
+    if (shiftHours <= 0.0 || shiftHours > 24.0) return -1;
+    return LaunchScript(ShiftScript(index, startHour, shiftHours));
+}
+
+// Ids of finished or already cancelled scripts return 0, even once their slot is reused
+extern "C" int CancelScript(int script) {
+    InitializeFleet();
+    int slot = FindScriptSlot(script);
+    if (slot < 0) return 0;
+    ReleaseScript(slot);
+    return 1;
+}
+
+extern "C" int IsScriptActive(int script) {
+    InitializeFleet();
+    return FindScriptSlot(script) >= 0 ? 1 : 0;
+}
+
+extern "C" int GetActiveScriptCount() {
+    InitializeFleet();
+    return activeScripts;
 }
 
 // Test function to verify the engine is working
@@ -143,6 +143,286 @@ void StopMotor();
 void ResetMotorState();
 void ResetPhysicsUpdateFlag();
 
+// ========================================================================
+// FLEET SIMULATION FUNCTIONS
+// ========================================================================
+int SetFleetSize(int count);
+int GetFleetSize();
+void StepFleet(double dtSeconds);
+double GetFleetSimulationTime();
+void StartMachine(int index);
+void StopMachine(int index);
+
+// ========================================================================
+// OEE FUNCTIONS (window: 0=Shift, 1=Day, 2=Week, 3=Lifetime; index -1 = fleet)
+// ========================================================================
+double GetMachineOEE(int index, int window);
+double GetMachineAvailability(int index, int window);
+double GetMachinePerformance(int index, int window);
+double GetMachineQuality(int index, int window);
+double GetFleetOEE(int window);
+
+// ========================================================================
+// ENERGY AND TARIFF FUNCTIONS
+// ========================================================================
+void SetTariffFlatRate(double pricePerKWh);
+void SetTariffBand(double startHour, double endHour, double pricePerKWh);
+void SetDemandCharge(double pricePerKW, double intervalMinutes);
+void ResetEnergyBillingPeriod();
+double GetCurrentTariffPrice();
+double GetMachineEnergyKWh(int index);
+double GetMachineEnergyCost(int index);
+double GetMachinePeakDemand(int index);
+double GetPlantPower();
+double GetPlantEnergyKWh();
+double GetPlantEnergyCost();
+double GetPlantPeakDemand();
+double GetPlantDemandCharge();
+double GetPlantTotalCost();
+
+// ========================================================================
+// MACHINE STATE LOG FUNCTIONS (MTBF / MTTR / uptime)
+// States: 0=Run, 1=Idle, 2=Warning, 3=Critical, 4=Maintenance Due
+// ========================================================================
+int GetMachineState(int index);
+int GetMachineIntervalCount(int index);
+int GetMachineFailureCount(int index);
+double GetMachineMTBF(int index);
+double GetMachineMTTR(int index);
+double GetMachineStateTime(int index, int state, double t0, double t1);
+double GetMachineUptime(int index, double t0, double t1);
+int FindMachinesInState(int state, double t0, double t1, int* machines, int maxMachines);
+int SetStateLogRetention(double hours);
+double GetFleetMTBF();
+double GetFleetMTTR();
+
+// ========================================================================
+// FLEET STATUS FUNCTIONS
+// Flags: 1=Running, 2=Stopped, 4=Warning, 8=Critical, 16=Maintenance Due
+// ========================================================================
+int CountMachinesWithStatus(int flags);
+int FindMachinesWithStatus(int flags, int* machines, int maxMachines);
+int GetFleetRunningCount();
+int GetFleetWarningCount();
+int GetFleetCriticalCount();
+int GetFleetMaintenanceDueCount();
+
+// ========================================================================
+// AT-RISK RANKING FUNCTIONS (metric: 0=Health, 1=Temperature, 2=Vibration, 3=RUL)
+// ========================================================================
+int GetTopRiskMachines(int metric, int k, int* machines);
+double GetMachineRUL(int index);
+
+// ========================================================================
+// MULTIVARIATE ANOMALY FUNCTIONS
+// Feature bits: 1=Temperature, 2=VibrationX, 4=VibrationY, 8=VibrationZ,
+//               16=Current, 32=Efficiency, 64=Power
+// ========================================================================
+void SetAnomalyFeatures(int featureMask);
+void SetAnomalyForgetting(double weight);
+double GetMachineMahalanobisDistance(int index);
+int FindAnomalousMachines(double threshold, int* machines, int maxMachines);
+
+// ========================================================================
+// KALMAN STATE ESTIMATE FUNCTIONS
+// ========================================================================
+double GetMachineEstimatedTemperature(int index);
+double GetMachineThermalRate(int index);
+double GetMachineEstimatedTorque(int index);
+double GetMachineEstimatedSpeed(int index);
+double GetMachineEstimatedVibration(int index);
+
+// ========================================================================
+// THERMAL IDENTIFICATION FUNCTIONS (RLS fit of R and C)
+// ========================================================================
+void SetThermalRLSForgetting(double lambda);
+double GetMachineThermalResistance(int index);
+double GetMachineThermalCapacitance(int index);
+double GetMachineThermalTimeConstant(int index);
+double ForecastMachineTemperature(int index, double horizonSeconds);
+
+// ========================================================================
+// CHANNEL FORECASTING FUNCTIONS (Holt-Winters, daily seasonality)
+// Channels: 0=Temperature, 1=Vibration, 2=Efficiency, 3=Power, 4=Speed, 5=Current
+// ========================================================================
+void SetForecastSmoothing(double alpha, double beta, double gamma);
+double ForecastMachineChannel(int index, int channel, double horizonSeconds);
+
+// ========================================================================
+// NATIVE ML INFERENCE FUNCTIONS (gradient-boosted trees, int8 MLP)
+// ========================================================================
+int GetSnapshotFeatureCount();
+int GetMachineSnapshotFeatures(int index, double* features);
+int LoadMLModel(const char* path);
+int GetMLModelCount();
+double GetMachineModelScore(int modelId, int index);
+int ScoreSnapshotBatch(int modelId, const double* features, int rows, double* scores);
+
+// ========================================================================
+// VIBRATION CONDITION INDICATOR FUNCTIONS
+// ========================================================================
+int ComputeVibrationFeatures(const float* samples, int channels, int samplesPerChannel, double* features);
+void SetVibrationWindowSamples(int samples);
+int EnableVibrationAnalysis(int index, int enabled);
+int IsVibrationAnalysisEnabled(int index);
+double GetMachineVibrationFeature(int index, int axis, int feature);
+
+// ========================================================================
+// SNAPSHOT HISTORY AND ISOLATION FOREST FUNCTIONS
+// ========================================================================
+int SetSnapshotHistoryCapacity(int steps);
+int GetSnapshotHistoryLength();
+int TrainIsolationForest(int trees, int sampleSize);
+double GetMachineIsolationScore(int index);
+int ScoreIsolationBatch(const double* features, int rows, double* scores);
+int FindIsolationAnomalies(double threshold, int* machines, int maxMachines);
+
+// ========================================================================
+// MATRIX PROFILE FUNCTIONS (motifs and discords)
+// ========================================================================
+int ComputeMatrixProfile(const double* series, int length, int window, double* profile, int* profileIndex);
+int ComputeMachineMatrixProfile(int index, int feature, int window);
+int GetMatrixProfileMotifs(int k, int* positions, int* neighbors, double* distances);
+int GetMatrixProfileDiscords(int k, int* positions, double* distances);
+
+// ========================================================================
+// CHANGE-POINT DETECTION FUNCTIONS (PELT)
+// ========================================================================
+int DetectChangePoints(const double* series, int length, int method, int costModel, double penalty, int minSegment,
+                       int* starts, int* ends, double* means, double* stdDevs, int maxSegments);
+int DetectFleetChangePoints(int feature, int method, int costModel, double penalty, int minSegment);
+int GetMachineSegments(int index, int* starts, int* ends, double* means, double* stdDevs, int maxSegments);
+
+// ========================================================================
+// SPECTRAL SIGNATURE SEARCH FUNCTIONS
+// ========================================================================
+int GetSpectralBandCount();
+void SetSpectralHistoryCapacity(int entries);
+int GetSpectralEntryCount();
+int GetMachineSpectralSignature(int index, double* bands);
+int BuildSpectralIndex(int lists, int iterations);
+int FindSimilarSpectra(const double* bands, int k, int nprobe, int* machines, double* times, double* similarities);
+int FindSimilarToMachine(int index, int k, int nprobe, int* machines, double* times, double* similarities);
+
+// ========================================================================
+// ACOUSTIC FILTER BANK FUNCTIONS (A-weighting, octave bands)
+// ========================================================================
+void SetAcousticBandMode(int thirdOctave);
+void SetAcousticBlockSamples(int samples);
+int EnableAcousticAnalysis(int index, int enabled);
+int IsAcousticAnalysisEnabled(int index);
+int GetAcousticBandCenters(double* centers);
+double GetMachineAcousticLevel(int index, int weighted);
+int GetMachineBandLevels(int index, double* levels);
+int AnalyzeAcousticSignal(const float* samples, int count, double* bandLevels, double* weightedLevel);
+
+// ========================================================================
+// THERMAL NETWORK FUNCTIONS (winding, core, rotor, bearings, housing)
+// ========================================================================
+int GetThermalNodeCount();
+double GetMachineNodeTemperature(int index, int node);
+double GetMachineHotSpotTemperature(int index, int* hotNode);
+int SetThermalConductance(int nodeA, int nodeB, double conductance);
+int SetThermalCapacity(int node, double capacity);
+
+// ========================================================================
+// HOUSING THERMAL GRID FUNCTIONS (2D heatmaps)
+// ========================================================================
+int EnableHousingGrid(int index, int enabled);
+int GetHousingGridWidth();
+int GetHousingGridHeight();
+int GetMachineHousingHeatmap(int index, int width, int height, double* heatmap);
+double GetMachineHousingMaxTemperature(int index);
+
+// ========================================================================
+// ROTOR DYNAMICS FUNCTIONS (Jeffcott rotor, orbit, displacement)
+// ========================================================================
+double GetMachineRotorVibration(int index, int axis);
+double GetMachineShaftDisplacement(int index);
+int GetMachineShaftOrbit(int index, double* x, double* y, int maxPoints);
+int SetMachineMisalignment(int index, double micrometres);
+void SetRotorDynamicsDrivesSensors(int enabled);
+int EnableRotorDynamics(int index, int enabled);
+int IsRotorDynamicsEnabled(int index);
+
+// ========================================================================
+// INDUCTION MACHINE ELECTRICAL FUNCTIONS (dq model, V/f drive)
+// ========================================================================
+int SetElectricalSampleRate(double hz);
+int SetDriveRampRate(double hzPerSecond);
+double GetMachineSupplyFrequency(int index);
+double GetMachineSlip(int index);
+double GetMachineRotorFlux(int index);
+double GetMachineElectromagneticTorque(int index);
+void SetElectricalModelDrivesSensors(int enabled);
+int EnableElectricalModel(int index, int enabled);
+int IsElectricalModelEnabled(int index);
+
+// ========================================================================
+// PLANT ELECTRICAL BUS FUNCTIONS (feeders, transformers, harmonics)
+// ========================================================================
+int ConfigureElectricalBus(int transformers, int feedersPerTransformer);
+int AssignMachineFeeder(int index, int feeder);
+int SetTransformerRating(int transformer, double kVA, double impedancePercent);
+int SetFeederImpedance(int feeder, double resistance, double reactance);
+double GetTransformerLoading(int transformer);
+double GetTransformerKFactor(int transformer);
+double GetTransformerVoltageDrop(int transformer);
+double GetTransformerVoltageTHD(int transformer);
+double GetFeederCurrent(int feeder);
+double GetFeederVoltageDrop(int feeder);
+int GetFeederHarmonicCurrents(int feeder, int* orders, double* magnitudes, int maxHarmonics);
+double GetPlantPowerFactor(int trueFactor);
+double GetPlantReactivePower();
+double GetPlantCurrentTHD();
+
+// ========================================================================
+// PROCESS LINE FUNCTIONS (load coupling over a dependency graph)
+// ========================================================================
+int AddProcessEdge(int upstream, int downstream, double share);
+void ClearProcessEdges();
+int SetProcessCoupling(double coupling);
+int GetProcessLevelCount();
+int GetMachineProcessLevel(int index);
+double GetMachineThroughput(int index);
+
+// ========================================================================
+// PLANT ENVIRONMENT FUNCTIONS (weather, day/night, season, zones)
+// ========================================================================
+int SetEnvironmentClock(int dayOfYear, double hourOfDay);
+int SetSiteClimate(double annualMean, double annualAmplitude, double dailyAmplitude, double meanHumidity);
+int AddPlantZone(double outdoorCoupling, double setpoint, double heatGain);
+int SetPlantZone(int zone, double outdoorCoupling, double setpoint, double heatGain);
+int AssignMachineZone(int index, int zone);
+int GetMachineZone(int index);
+int GetPlantZoneCount();
+double GetZoneTemperature(int zone);
+double GetZoneHumidity(int zone);
+double GetOutdoorTemperature();
+double GetOutdoorHumidity();
+double GetPlantAmbientPressure();
+
+// ========================================================================
+// DUTY-CYCLE FUNCTIONS (IEC 60034-1 S1-S10 schedules)
+// ========================================================================
+int CreateStandardDutyProfile(int dutyType, double periodSeconds, double dutyFactor, double load);
+int CreateDutyProfile(const double* durations, const double* loadStart, const double* loadEnd,
+                      const double* speedStart, const double* speedEnd, const int* running, int segments);
+int AssignMachineDutyProfile(int index, int profile, double phaseSeconds);
+int GetDutyProfileCount();
+double GetDutyProfilePeriod(int profile);
+int GetMachineDutySegment(int index);
+double GetMachineDutyLoad(int index);
+
+// ========================================================================
+// BEHAVIOR SCRIPT FUNCTIONS (coroutines on simulated time)
+// ========================================================================
+int StartMaintenanceScript(int index, double downtimeSeconds, double rampSeconds);
+int StartShiftScript(int index, double startHour, double shiftHours);
+int CancelScript(int script);
+int IsScriptActive(int script);
+int GetActiveScriptCount();
+
 // ========================================================================
 // TEST FUNCTION
 // ========================================================================
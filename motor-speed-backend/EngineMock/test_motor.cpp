@@ -1,6 +1,19 @@
 #include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
 #include "motor_engine.hpp"
 
+static int failedChecks = 0;
+
+// Report a failed expectation and fail the run without stopping it
+static void Check(bool ok, const char* what) {
+    if (!ok) {
+        std::cout << "❌ Check failed: " << what << std::endl;
+        failedChecks++;
+    }
+}
+
 int main() {
     std::cout << "Testing Real Industrial Motor Physics Engine..." << std::endl;
     
@@ -19,6 +32,99 @@ int main() {
         std::cout << "Vibration: " << GetMotorVibration() << " mm/s" << std::endl;
         std::cout << "Operating Hours: " << GetMotorOperatingHours() << " hours" << std::endl;
         
+        // Test fleet simulation: one 8-hour shift in 1-minute steps
+        std::cout << "\n🏭 Fleet Simulation Tests:" << std::endl;
+        StopMachine(3);
+        SetSnapshotHistoryCapacity(512);  // Training data for the isolation forest, matrix profile and change points
+        EnableHousingGrid(0, 1);
+        for (int i = 0; i < 4; i++) EnableVibrationAnalysis(i, 1);  // Windows and spectra for machines 0-3
+        EnableAcousticAnalysis(0, 1);
+        EnableRotorDynamics(0, 1);
+        EnableElectricalModel(0, 1);
+        AddProcessEdge(3, 4, 1.0);  // Machine 4 is fed by the stopped machine 3
+        AssignMachineDutyProfile(5, CreateStandardDutyProfile(3, 600.0, 0.5, 0.8), 0.0);  // S3: 5 min on, 5 min off
+        StartShiftScript(6, 0.0, 4.0);             // Machine 6 runs a 4-hour shift from midnight
+        StartMaintenanceScript(7, 1800.0, 600.0);  // Machine 7: 30 min service, 10 min ramp-up
+        for (int step = 0; step < 480; step++) {
+            StepFleet(60.0);
+        }
+        std::cout << "Machines: " << GetFleetSize() << std::endl;
+        std::cout << "Fleet OEE (shift): " << GetFleetOEE(0) << "%" << std::endl;
+        std::cout << "Machine 3 Availability (shift): " << GetMachineAvailability(3, 0) << "%" << std::endl;
+        Check(GetMachineAvailability(3, 0) == 0.0, "stopped machine 3 has zero availability");
+        std::cout << "Plant Energy (shift): " << GetPlantEnergyKWh() << " kWh, $" << GetPlantEnergyCost() << std::endl;
+        std::cout << "Plant Peak Demand: " << GetPlantPeakDemand() << " kW" << std::endl;
+        int criticalMachines[32];
+        std::cout << "Fleet MTBF: " << GetFleetMTBF() << " h, MTTR: " << GetFleetMTTR() << " h" << std::endl;
+        std::cout << "Machines critical in first hour: " << FindMachinesInState(3, 0.0, 3600.0, criticalMachines, 32) << std::endl;
+        std::cout << "Machine 0 Uptime (first hour): " << GetMachineUptime(0, 0.0, 3600.0) / 60.0 << " min" << std::endl;
+        std::cout << "Running: " << GetFleetRunningCount() << ", Warning: " << GetFleetWarningCount()
+                  << ", Critical: " << GetFleetCriticalCount() << std::endl;
+        int worstMachines[3];
+        int worstCount = GetTopRiskMachines(0, 3, worstMachines);
+        std::cout << "Lowest health machines:";
+        for (int i = 0; i < worstCount; i++) std::cout << " #" << worstMachines[i];
+        std::cout << std::endl;
+        std::cout << "Machine 0 Mahalanobis distance: " << GetMachineMahalanobisDistance(0) << std::endl;
+        std::cout << "Machine 0 Filtered Temperature: " << GetMachineEstimatedTemperature(0) << " °C" << std::endl;
+        std::cout << "Machine 0 Thermal Time Constant: " << GetMachineThermalTimeConstant(0) << " s" << std::endl;
+        std::cout << "Machine 0 Temperature Forecast (+1h): " << ForecastMachineChannel(0, 0, 3600.0) << " °C" << std::endl;
+        
+        // Single-stump model, raw margin: hot machines (feature 0 >= 80 °C) score 2, the rest -2
+        std::ofstream("test_model_gbt.txt") << "gbt 1 3 0 0\nroots 0\n0 80 1 2 0\n-1 0 0 0 -2\n-1 0 0 0 2\n";
+        int modelId = LoadMLModel("test_model_gbt.txt");
+        std::remove("test_model_gbt.txt");
+        double snapshotFeatures[32] = {};
+        GetMachineSnapshotFeatures(0, snapshotFeatures);
+        std::cout << "Machine 0 GBT Score: " << GetMachineModelScore(modelId, 0) << std::endl;
+        Check(modelId >= 0, "GBT stump model loads");
+        Check(GetMachineModelScore(modelId, 0) == (snapshotFeatures[0] >= 80.0 ? 2.0 : -2.0), "GBT stump scores +/-2 by temperature");
+        std::cout << "Machine 0 X-Axis Kurtosis: " << GetMachineVibrationFeature(0, 0, 3) << std::endl;
+        TrainIsolationForest(100, 256);
+        std::cout << "Machine 0 Isolation Score: " << GetMachineIsolationScore(0) << std::endl;
+        int discord = 0;
+        double discordDistance = 0.0;
+        ComputeMachineMatrixProfile(0, 0, 30);
+        GetMatrixProfileDiscords(1, &discord, &discordDistance);
+        std::cout << "Machine 0 Temperature Discord: step " << discord << " (distance " << discordDistance << ")" << std::endl;
+        DetectFleetChangePoints(0, 0, 1, 0.0, 0);
+        std::cout << "Machine 0 Temperature Segments: " << GetMachineSegments(0, nullptr, nullptr, nullptr, nullptr, 1000) << std::endl;
+        int similarMachine = -1;
+        double similarTime = 0.0, similarity = 0.0;
+        FindSimilarToMachine(0, 1, 0, &similarMachine, &similarTime, &similarity);
+        std::cout << "Machine 0 Closest Spectrum: machine " << similarMachine << " at " << similarTime << " s (cosine " << similarity << ")" << std::endl;
+        std::cout << "Machine 0 Sound Level: " << GetMachineAcousticLevel(0, 1) << " dBA (" << GetMachineAcousticLevel(0, 0) << " dB unweighted)" << std::endl;
+        int hotNode = 0;
+        double hotSpot = GetMachineHotSpotTemperature(0, &hotNode);
+        std::cout << "Machine 0 Hot Spot: " << hotSpot << " °C (node " << hotNode << ")" << std::endl;
+        std::cout << "Machine 0 Housing Max: " << GetMachineHousingMaxTemperature(0) << " °C" << std::endl;
+        std::cout << "Machine 0 Shaft Displacement: " << GetMachineShaftDisplacement(0) << " mm" << std::endl;
+        std::cout << "Machine 0 Slip: " << GetMachineSlip(0) * 100.0 << "% at " << GetMachineSupplyFrequency(0) << " Hz" << std::endl;
+        std::cout << "Plant Power Factor: " << GetPlantPowerFactor(1) << " (displacement " << GetPlantPowerFactor(0)
+                  << "), Transformer 0 Loading: " << GetTransformerLoading(0) << "%" << std::endl;
+        double starvedThroughput = GetMachineThroughput(4);
+        std::cout << "Machine 4 Throughput (starved by #3): " << starvedThroughput << std::endl;
+        std::cout << "Outdoor: " << GetOutdoorTemperature() << " °C, Zone 0: " << GetZoneTemperature(0) << " °C, "
+                  << GetZoneHumidity(0) << "% RH" << std::endl;
+        std::cout << "Machine 5 Duty Segment (S3): " << GetMachineDutySegment(5) << ", scheduled load " << GetMachineDutyLoad(5) << std::endl;
+        // 8 h is a whole number of 10-minute periods: the cycle is back at the start of its 5-minute on segment
+        Check(GetMachineDutySegment(5) == 0, "S3 machine 5 is in its on segment at 8 h");
+        Check(std::fabs(GetMachineDutyLoad(5) - 0.8) < 1e-9, "S3 machine 5 runs its scheduled load");
+        std::cout << "Machine 6 Idle after shift: " << (GetMachineState(6) == 1 ? "yes" : "no")
+                  << ", Active Scripts: " << GetActiveScriptCount() << std::endl;
+        Check(GetMachineState(6) == 1, "machine 6 is idle after its 4-hour shift");
+        Check(GetActiveScriptCount() == 1, "only the shift script is left once maintenance has finished");
+
+        // Without its stopped feeder machine 4 runs at its own load again
+        ClearProcessEdges();
+        StepFleet(60.0);
+        Check(starvedThroughput < GetMachineThroughput(4), "machine 4 throughput is below its own load while starved");
+
+        if (failedChecks > 0) {
+            std::cout << "❌ " << failedChecks << " fleet check(s) failed" << std::endl;
+            return 1;
+        }
+        std::cout << "✅ Fleet checks passed" << std::endl;
         return 0;
     } else {
         std::cout << "❌ C++ Engine test failed!" << std::endl;
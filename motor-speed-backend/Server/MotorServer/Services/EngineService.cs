@@ -239,6 +239,539 @@ namespace MotorServer.Services
         [DllImport(LIB_NAME)]
         public static extern void ResetPhysicsUpdateFlag();
 
+        // Fleet simulation functions
+        [DllImport(LIB_NAME)]
+        public static extern int SetFleetSize(int count);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetFleetSize();
+
+        [DllImport(LIB_NAME)]
+        public static extern void StepFleet(double dtSeconds);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetFleetSimulationTime();
+
+        [DllImport(LIB_NAME)]
+        public static extern void StartMachine(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern void StopMachine(int index);
+
+        // OEE functions (window: 0=Shift, 1=Day, 2=Week, 3=Lifetime; index -1 = fleet)
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineOEE(int index, int window);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineAvailability(int index, int window);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachinePerformance(int index, int window);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineQuality(int index, int window);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetFleetOEE(int window);
+
+        // Energy and tariff functions
+        [DllImport(LIB_NAME)]
+        public static extern void SetTariffFlatRate(double pricePerKWh);
+
+        [DllImport(LIB_NAME)]
+        public static extern void SetTariffBand(double startHour, double endHour, double pricePerKWh);
+
+        [DllImport(LIB_NAME)]
+        public static extern void SetDemandCharge(double pricePerKW, double intervalMinutes);
+
+        [DllImport(LIB_NAME)]
+        public static extern void ResetEnergyBillingPeriod();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetCurrentTariffPrice();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineEnergyKWh(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineEnergyCost(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachinePeakDemand(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetPlantPower();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetPlantEnergyKWh();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetPlantEnergyCost();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetPlantPeakDemand();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetPlantDemandCharge();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetPlantTotalCost();
+
+        // Machine state log functions (0=Run, 1=Idle, 2=Warning, 3=Critical, 4=Maintenance Due)
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineState(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineIntervalCount(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineFailureCount(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineMTBF(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineMTTR(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineStateTime(int index, int state, double t0, double t1);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineUptime(int index, double t0, double t1);
+
+        [DllImport(LIB_NAME)]
+        public static extern int FindMachinesInState(int state, double t0, double t1, int[] machines, int maxMachines);
+
+        [DllImport(LIB_NAME)]
+        public static extern int SetStateLogRetention(double hours);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetFleetMTBF();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetFleetMTTR();
+
+        // Fleet status functions (flags: 1=Running, 2=Stopped, 4=Warning, 8=Critical, 16=Maintenance Due)
+        [DllImport(LIB_NAME)]
+        public static extern int CountMachinesWithStatus(int flags);
+
+        [DllImport(LIB_NAME)]
+        public static extern int FindMachinesWithStatus(int flags, int[] machines, int maxMachines);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetFleetRunningCount();
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetFleetWarningCount();
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetFleetCriticalCount();
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetFleetMaintenanceDueCount();
+
+        // At-risk ranking functions (metric: 0=Health, 1=Temperature, 2=Vibration, 3=RUL)
+        [DllImport(LIB_NAME)]
+        public static extern int GetTopRiskMachines(int metric, int k, int[] machines);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineRUL(int index);
+
+        // Multivariate anomaly functions (feature bits: 1=Temperature, 2/4/8=Vibration X/Y/Z, 16=Current, 32=Efficiency, 64=Power)
+        [DllImport(LIB_NAME)]
+        public static extern void SetAnomalyFeatures(int featureMask);
+
+        [DllImport(LIB_NAME)]
+        public static extern void SetAnomalyForgetting(double weight);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineMahalanobisDistance(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern int FindAnomalousMachines(double threshold, int[] machines, int maxMachines);
+
+        // Kalman state estimate functions
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineEstimatedTemperature(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineThermalRate(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineEstimatedTorque(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineEstimatedSpeed(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineEstimatedVibration(int index);
+
+        // Thermal identification functions
+        [DllImport(LIB_NAME)]
+        public static extern void SetThermalRLSForgetting(double lambda);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineThermalResistance(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineThermalCapacitance(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineThermalTimeConstant(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double ForecastMachineTemperature(int index, double horizonSeconds);
+
+        // Channel forecasting functions (0=Temperature, 1=Vibration, 2=Efficiency, 3=Power, 4=Speed, 5=Current)
+        [DllImport(LIB_NAME)]
+        public static extern void SetForecastSmoothing(double alpha, double beta, double gamma);
+
+        [DllImport(LIB_NAME)]
+        public static extern double ForecastMachineChannel(int index, int channel, double horizonSeconds);
+
+        // Native ML inference functions
+        [DllImport(LIB_NAME)]
+        public static extern int GetSnapshotFeatureCount();
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineSnapshotFeatures(int index, double[] features);
+
+        [DllImport(LIB_NAME)]
+        public static extern int LoadMLModel(string path);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMLModelCount();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineModelScore(int modelId, int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern int ScoreSnapshotBatch(int modelId, double[] features, int rows, double[] scores);
+
+        // Vibration condition indicator functions
+        [DllImport(LIB_NAME)]
+        public static extern int ComputeVibrationFeatures(float[] samples, int channels, int samplesPerChannel, double[] features);
+
+        [DllImport(LIB_NAME)]
+        public static extern void SetVibrationWindowSamples(int samples);
+
+        [DllImport(LIB_NAME)]
+        public static extern int EnableVibrationAnalysis(int index, int enabled);
+
+        [DllImport(LIB_NAME)]
+        public static extern int IsVibrationAnalysisEnabled(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineVibrationFeature(int index, int axis, int feature);
+
+        // Snapshot history and isolation forest functions
+        [DllImport(LIB_NAME)]
+        public static extern int SetSnapshotHistoryCapacity(int steps);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetSnapshotHistoryLength();
+
+        [DllImport(LIB_NAME)]
+        public static extern int TrainIsolationForest(int trees, int sampleSize);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineIsolationScore(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern int ScoreIsolationBatch(double[] features, int rows, double[] scores);
+
+        [DllImport(LIB_NAME)]
+        public static extern int FindIsolationAnomalies(double threshold, int[] machines, int maxMachines);
+
+        // Matrix profile functions
+        [DllImport(LIB_NAME)]
+        public static extern int ComputeMatrixProfile(double[] series, int length, int window, double[] profile, int[] profileIndex);
+
+        [DllImport(LIB_NAME)]
+        public static extern int ComputeMachineMatrixProfile(int index, int feature, int window);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMatrixProfileMotifs(int k, int[] positions, int[] neighbors, double[] distances);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMatrixProfileDiscords(int k, int[] positions, double[] distances);
+
+        // Change-point detection functions
+        [DllImport(LIB_NAME)]
+        public static extern int DetectChangePoints(double[] series, int length, int method, int costModel, double penalty, int minSegment, int[] starts, int[] ends, double[] means, double[] stdDevs, int maxSegments);
+
+        [DllImport(LIB_NAME)]
+        public static extern int DetectFleetChangePoints(int feature, int method, int costModel, double penalty, int minSegment);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineSegments(int index, int[] starts, int[] ends, double[] means, double[] stdDevs, int maxSegments);
+
+        // Spectral signature search functions
+        [DllImport(LIB_NAME)]
+        public static extern int GetSpectralBandCount();
+
+        [DllImport(LIB_NAME)]
+        public static extern void SetSpectralHistoryCapacity(int entries);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetSpectralEntryCount();
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineSpectralSignature(int index, double[] bands);
+
+        [DllImport(LIB_NAME)]
+        public static extern int BuildSpectralIndex(int lists, int iterations);
+
+        [DllImport(LIB_NAME)]
+        public static extern int FindSimilarSpectra(double[] bands, int k, int nprobe, int[] machines, double[] times, double[] similarities);
+
+        [DllImport(LIB_NAME)]
+        public static extern int FindSimilarToMachine(int index, int k, int nprobe, int[] machines, double[] times, double[] similarities);
+
+        // Acoustic filter bank functions
+        [DllImport(LIB_NAME)]
+        public static extern void SetAcousticBandMode(int thirdOctave);
+
+        [DllImport(LIB_NAME)]
+        public static extern void SetAcousticBlockSamples(int samples);
+
+        [DllImport(LIB_NAME)]
+        public static extern int EnableAcousticAnalysis(int index, int enabled);
+
+        [DllImport(LIB_NAME)]
+        public static extern int IsAcousticAnalysisEnabled(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetAcousticBandCenters(double[] centers);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineAcousticLevel(int index, int weighted);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineBandLevels(int index, double[] levels);
+
+        [DllImport(LIB_NAME)]
+        public static extern int AnalyzeAcousticSignal(float[] samples, int count, double[] bandLevels, double[] weightedLevel);
+
+        // Thermal network functions
+        [DllImport(LIB_NAME)]
+        public static extern int GetThermalNodeCount();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineNodeTemperature(int index, int node);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineHotSpotTemperature(int index, int[] hotNode);
+
+        [DllImport(LIB_NAME)]
+        public static extern int SetThermalConductance(int nodeA, int nodeB, double conductance);
+
+        [DllImport(LIB_NAME)]
+        public static extern int SetThermalCapacity(int node, double capacity);
+
+        // Housing thermal grid functions
+        [DllImport(LIB_NAME)]
+        public static extern int EnableHousingGrid(int index, int enabled);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetHousingGridWidth();
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetHousingGridHeight();
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineHousingHeatmap(int index, int width, int height, double[] heatmap);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineHousingMaxTemperature(int index);
+
+        // Rotor dynamics
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineRotorVibration(int index, int axis);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineShaftDisplacement(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineShaftOrbit(int index, double[] x, double[] y, int maxPoints);
+
+        [DllImport(LIB_NAME)]
+        public static extern int SetMachineMisalignment(int index, double micrometres);
+
+        [DllImport(LIB_NAME)]
+        public static extern void SetRotorDynamicsDrivesSensors(int enabled);
+
+        [DllImport(LIB_NAME)]
+        public static extern int EnableRotorDynamics(int index, int enabled);
+
+        [DllImport(LIB_NAME)]
+        public static extern int IsRotorDynamicsEnabled(int index);
+
+        // Induction machine electrical model
+        [DllImport(LIB_NAME)]
+        public static extern int SetElectricalSampleRate(double hz);
+
+        [DllImport(LIB_NAME)]
+        public static extern int SetDriveRampRate(double hzPerSecond);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineSupplyFrequency(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineSlip(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineRotorFlux(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineElectromagneticTorque(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern void SetElectricalModelDrivesSensors(int enabled);
+
+        [DllImport(LIB_NAME)]
+        public static extern int EnableElectricalModel(int index, int enabled);
+
+        [DllImport(LIB_NAME)]
+        public static extern int IsElectricalModelEnabled(int index);
+
+        // Plant electrical bus
+        [DllImport(LIB_NAME)]
+        public static extern int ConfigureElectricalBus(int transformers, int feedersPerTransformer);
+
+        [DllImport(LIB_NAME)]
+        public static extern int AssignMachineFeeder(int index, int feeder);
+
+        [DllImport(LIB_NAME)]
+        public static extern int SetTransformerRating(int transformer, double kVA, double impedancePercent);
+
+        [DllImport(LIB_NAME)]
+        public static extern int SetFeederImpedance(int feeder, double resistance, double reactance);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetTransformerLoading(int transformer);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetTransformerKFactor(int transformer);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetTransformerVoltageDrop(int transformer);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetTransformerVoltageTHD(int transformer);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetFeederCurrent(int feeder);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetFeederVoltageDrop(int feeder);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetFeederHarmonicCurrents(int feeder, int[] orders, double[] magnitudes, int maxHarmonics);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetPlantPowerFactor(int trueFactor);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetPlantReactivePower();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetPlantCurrentTHD();
+
+        // Process lines
+        [DllImport(LIB_NAME)]
+        public static extern int AddProcessEdge(int upstream, int downstream, double share);
+
+        [DllImport(LIB_NAME)]
+        public static extern void ClearProcessEdges();
+
+        [DllImport(LIB_NAME)]
+        public static extern int SetProcessCoupling(double coupling);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetProcessLevelCount();
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineProcessLevel(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineThroughput(int index);
+
+        // Plant environment
+        [DllImport(LIB_NAME)]
+        public static extern int SetEnvironmentClock(int dayOfYear, double hourOfDay);
+
+        [DllImport(LIB_NAME)]
+        public static extern int SetSiteClimate(double annualMean, double annualAmplitude, double dailyAmplitude, double meanHumidity);
+
+        [DllImport(LIB_NAME)]
+        public static extern int AddPlantZone(double outdoorCoupling, double setpoint, double heatGain);
+
+        [DllImport(LIB_NAME)]
+        public static extern int SetPlantZone(int zone, double outdoorCoupling, double setpoint, double heatGain);
+
+        [DllImport(LIB_NAME)]
+        public static extern int AssignMachineZone(int index, int zone);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineZone(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetPlantZoneCount();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetZoneTemperature(int zone);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetZoneHumidity(int zone);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetOutdoorTemperature();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetOutdoorHumidity();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetPlantAmbientPressure();
+
+        // Duty cycles
+        [DllImport(LIB_NAME)]
+        public static extern int CreateStandardDutyProfile(int dutyType, double periodSeconds, double dutyFactor, double load);
+
+        [DllImport(LIB_NAME)]
+        public static extern int CreateDutyProfile(double[] durations, double[] loadStart, double[] loadEnd, double[] speedStart, double[] speedEnd, int[] running, int segments);
+
+        [DllImport(LIB_NAME)]
+        public static extern int AssignMachineDutyProfile(int index, int profile, double phaseSeconds);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetDutyProfileCount();
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetDutyProfilePeriod(int profile);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetMachineDutySegment(int index);
+
+        [DllImport(LIB_NAME)]
+        public static extern double GetMachineDutyLoad(int index);
+
+        // Behavior scripts
+        [DllImport(LIB_NAME)]
+        public static extern int StartMaintenanceScript(int index, double downtimeSeconds, double rampSeconds);
+
+        [DllImport(LIB_NAME)]
+        public static extern int StartShiftScript(int index, double startHour, double shiftHours);
+
+        [DllImport(LIB_NAME)]
+        public static extern int CancelScript(int script);
+
+        [DllImport(LIB_NAME)]
+        public static extern int IsScriptActive(int script);
+
+        [DllImport(LIB_NAME)]
+        public static extern int GetActiveScriptCount();
+
         // Test function
         [DllImport(LIB_NAME)]
         public static extern int TestEngine();